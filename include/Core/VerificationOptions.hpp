@@ -1,6 +1,7 @@
 #ifndef VERIFICATIONOPTIONS_HPP_
 #define VERIFICATIONOPTIONS_HPP_
 
+#include <cstdint>
 #include <string>
 #include <iosfwd>
 #include <utility>
@@ -38,6 +39,10 @@ namespace VerifyTAPN {
             ANY_TRACE, SATISFYING_TRACES, UNSATISFYING_TRACES
         };
 
+        enum SMCEstimationMethod {
+            FIXED_ESTIMATION, WILSON_ESTIMATION, BAYESIAN_ESTIMATION
+        };
+
         VerificationOptions() = default;
 
     public: // inspectors
@@ -195,6 +200,38 @@ namespace VerifyTAPN {
             partialOrder = v;
         }
 
+        inline bool getQueryGuidedReduction() const {
+            return queryGuidedReduction;
+        }
+
+        inline void setQueryGuidedReduction(bool v) {
+            queryGuidedReduction = v;
+        }
+
+        inline bool getSharedExploration() const {
+            return sharedExploration;
+        }
+
+        inline void setSharedExploration(bool v) {
+            sharedExploration = v;
+        }
+
+        inline unsigned int getThreads() const {
+            return threads;
+        }
+
+        inline void setThreads(unsigned int value) {
+            threads = value;
+        }
+
+        inline const std::string& getStateSpaceCache() const {
+            return stateSpaceCache;
+        }
+
+        inline void setStateSpaceCache(const std::string& file) {
+            stateSpaceCache = file;
+        }
+
         inline const std::string& getStrategyFile() const {
             return strategy_output;
         }
@@ -227,6 +264,51 @@ namespace VerifyTAPN {
             parallel = value;
         }
 
+        inline unsigned int getSmcThreads() const {
+            return smcThreads;
+        }
+
+        inline void setSmcThreads(const unsigned int value) {
+            smcThreads = value;
+        }
+
+        inline unsigned int getSmcBatch() const {
+            return smcBatch;
+        }
+
+        inline void setSmcBatch(const unsigned int value) {
+            smcBatch = value;
+        }
+
+        inline unsigned int getSmcSplitting() const {
+            return smcSplitting;
+        }
+
+        inline void setSmcSplitting(const unsigned int value) {
+            smcSplitting = value;
+        }
+
+        inline unsigned int getSmcSplittingReplications() const {
+            return smcSplittingReplications;
+        }
+
+        inline void setSmcSplittingReplications(const unsigned int value) {
+            smcSplittingReplications = value;
+        }
+
+        inline bool hasSeed() const {
+            return seeded;
+        }
+
+        inline uint64_t getSeed() const {
+            return seed;
+        }
+
+        inline void setSeed(const uint64_t value) {
+            seed = value;
+            seeded = true;
+        }
+
         inline bool mustPrintCumulative() const {
             return printCumulative;
         }
@@ -275,6 +357,14 @@ namespace VerifyTAPN {
             smcTracesType = toSave;
         }
 
+        inline SMCEstimationMethod getSMCEstimationMethod() const {
+            return smcEstimationMethod;
+        }
+
+        inline void setSMCEstimationMethod(const SMCEstimationMethod method) {
+            smcEstimationMethod = method;
+        }
+
         inline void setSMCNumericPrecision(const unsigned int precision) {
             smcNumericPrecision = precision;
         }
@@ -300,6 +390,10 @@ namespace VerifyTAPN {
         long long workflowBound = 0;
         bool calculateCmax = false;
         bool partialOrder{};
+        bool queryGuidedReduction = false;
+        bool sharedExploration = false;
+        unsigned int threads = 1;
+        std::string stateSpaceCache;
         std::string outputFile;
         std::string outputQuery;
         std::set<size_t> querynumbers;
@@ -307,6 +401,12 @@ namespace VerifyTAPN {
         bool benchmark = false;
         unsigned int benchmarkRuns = 100;
         bool parallel = false;
+        unsigned int smcThreads = 0;
+        unsigned int smcBatch = 0;
+        unsigned int smcSplitting = 0;
+        unsigned int smcSplittingReplications = 10;
+        bool seeded = false;
+        uint64_t seed = 0;
         bool printCumulative = false;
         unsigned int cumulativeRoundingDigits = 2;
         unsigned int stepsStatsScale = 2000;
@@ -314,6 +414,7 @@ namespace VerifyTAPN {
         bool timeStdDev = false;
         unsigned int smcTraces = 0;
         SMCTracesType smcTracesType = ANY_TRACE;
+        SMCEstimationMethod smcEstimationMethod = FIXED_ESTIMATION;
         unsigned int smcNumericPrecision = 5;
         friend class ArgsParser;
     };
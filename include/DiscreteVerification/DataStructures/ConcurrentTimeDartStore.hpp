@@ -0,0 +1,80 @@
+/*
+ * ConcurrentTimeDartStore.hpp
+ *
+ * Passed/waiting store of time darts shared by the workers of the parallel time dart reachability search.
+ */
+
+#ifndef CONCURRENTTIMEDARTSTORE_HPP_
+#define CONCURRENTTIMEDARTSTORE_HPP_
+
+#include "NonStrictMarkingBase.hpp"
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "google/sparse_hash_map"
+
+namespace VerifyTAPN { namespace DiscreteVerification {
+
+    /**
+     * Time dart whose waiting and passed values only decrease and are updated with atomic min operations, so
+     * several workers can extend and explore the same dart. The base marking is never changed once stored.
+     */
+    class ConcurrentTimeDart {
+    public:
+        ConcurrentTimeDart(NonStrictMarkingBase *base, int waiting)
+                : base(base), waiting(waiting), passed(std::numeric_limits<int32_t>::max()), queued(true) {}
+
+        inline NonStrictMarkingBase *getBase() const { return base; }
+
+        /**
+         * Marks the delays [from, to] as passed, where from is the waiting value and to the passed value minus one.
+         * Returns false if another worker already claimed them. Must be called after the dart is popped from the
+         * frontier, any later decrease of the waiting value queues the dart again.
+         */
+        bool claim(int &from, int &to);
+
+    private:
+        friend class ConcurrentTimeDartStore;
+
+        NonStrictMarkingBase *base;
+        std::atomic<int> waiting;
+        std::atomic<int> passed;
+        std::atomic<bool> queued; // in the frontier and not popped yet
+    };
+
+    class ConcurrentTimeDartStore {
+    public:
+        explicit ConcurrentTimeDartStore(size_t shards);
+
+        ~ConcurrentTimeDartStore();
+
+        ConcurrentTimeDartStore(const ConcurrentTimeDartStore &) = delete;
+        ConcurrentTimeDartStore &operator=(const ConcurrentTimeDartStore &) = delete;
+
+        /**
+         * Adds a marking (in base form) reached with the given youngest token age. The store takes ownership of
+         * marking. Returns the dart that must be pushed on the frontier, if any, and whether marking was new.
+         */
+        std::pair<ConcurrentTimeDart *, bool> add(NonStrictMarkingBase *marking, int youngest);
+
+        inline long long size() const { return stored.load(std::memory_order_relaxed); }
+
+    private:
+        typedef google::sparse_hash_map<size_t, std::vector<ConcurrentTimeDart *>> HashMap;
+
+        struct alignas(64) Shard {
+            std::mutex lock;
+            HashMap darts;
+        };
+
+        size_t nshards;
+        std::unique_ptr<Shard[]> shards;
+        std::atomic<long long> stored{0};
+    };
+
+} } /* namespace VerifyTAPN */
+
+#endif /* CONCURRENTTIMEDARTSTORE_HPP_ */
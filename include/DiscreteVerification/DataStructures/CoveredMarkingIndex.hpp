@@ -0,0 +1,124 @@
+/*
+ * CoveredMarkingIndex.hpp
+ *
+ * Index over stored markings answering whether some stored marking is covered by a given marking.
+ */
+
+#ifndef COVEREDMARKINGINDEX_HPP_
+#define COVEREDMARKINGINDEX_HPP_
+
+#include "NonStrictMarkingBase.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace VerifyTAPN { namespace DiscreteVerification {
+
+    /**
+     * A stored marking m is covered by a marking M if every token of m (same place and age) is also in M, and M has
+     * more tokens. The index keeps a signature of each stored marking: the set of places holding tokens and the set
+     * of (place, age) pairs, both folded into 64 bits, and the number of tokens. If m is covered by M, each set of m
+     * is a subset of the one of M, so most stored markings are rejected with a few bit operations. Markings are
+     * grouped by their place set, a whole group is skipped when its place set is not a subset of the one of M or
+     * all its markings are too large. The remaining candidates are handed to the caller for the exact check.
+     */
+    template<typename T>
+    class CoveredMarkingIndex {
+    public:
+        void add(const NonStrictMarkingBase &marking, const T &handle) {
+            Signature signature = signatureOf(marking);
+            auto res = bucketOf.emplace(signature.places, buckets.size());
+            if (res.second) {
+                buckets.emplace_back(signature.places);
+            }
+            Bucket &bucket = buckets[res.first->second];
+            bucket.minSize = std::min(bucket.minSize, signature.size);
+            bucket.entries.push_back(Entry{signature.tokens, signature.size, handle});
+        }
+
+        /**
+         * Calls covered on the stored markings that may be covered by marking until it returns true. Returns whether
+         * it did.
+         */
+        template<typename F>
+        bool find(const NonStrictMarkingBase &marking, F &&covered) const {
+            Signature signature = signatureOf(marking);
+            for (const Bucket &bucket : buckets) {
+                if ((bucket.places & ~signature.places) != 0 || bucket.minSize >= signature.size) continue;
+                for (const Entry &entry : bucket.entries) {
+                    if (entry.size < signature.size && (entry.tokens & ~signature.tokens) == 0 &&
+                        covered(entry.handle)) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        // True if every token of small is in large; place and token lists are sorted, so one pass suffices.
+        static bool covers(const NonStrictMarkingBase &large, const NonStrictMarkingBase &small) {
+            auto large_place = large.getPlaceList().begin();
+            auto large_end = large.getPlaceList().end();
+            for (const auto &place : small.getPlaceList()) {
+                while (large_place != large_end && large_place->place != place.place) {
+                    ++large_place;
+                }
+                if (large_place == large_end) return false;
+
+                auto large_token = large_place->tokens.begin();
+                for (const auto &token : place.tokens) {
+                    while (large_token != large_place->tokens.end() && large_token->getAge() != token.getAge()) {
+                        ++large_token;
+                    }
+                    if (large_token == large_place->tokens.end() || large_token->getCount() < token.getCount()) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+    private:
+        struct Signature {
+            uint64_t places = 0;
+            uint64_t tokens = 0;
+            uint32_t size = 0;
+        };
+
+        struct Entry {
+            uint64_t tokens;
+            uint32_t size;
+            T handle;
+        };
+
+        struct Bucket {
+            explicit Bucket(uint64_t places) : places(places) {}
+
+            uint64_t places;
+            uint32_t minSize = UINT32_MAX;
+            std::vector<Entry> entries;
+        };
+
+        static Signature signatureOf(const NonStrictMarkingBase &marking) {
+            Signature signature;
+            for (const auto &place : marking.getPlaceList()) {
+                uint32_t index = place.place->getIndex();
+                signature.places |= uint64_t(1) << (index % 64);
+                for (const auto &token : place.tokens) {
+                    uint32_t mix = index * 0x9E3779B1u + uint32_t(token.getAge()) * 0x85EBCA77u;
+                    signature.tokens |= uint64_t(1) << (mix >> 26);
+                    signature.size += token.getCount();
+                }
+            }
+            return signature;
+        }
+
+        std::vector<Bucket> buckets;
+        std::unordered_map<uint64_t, size_t> bucketOf;
+    };
+
+} } /* namespace VerifyTAPN */
+
+#endif /* COVEREDMARKINGINDEX_HPP_ */
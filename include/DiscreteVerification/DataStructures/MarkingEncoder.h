@@ -20,12 +20,8 @@
 using namespace ptrie;
 namespace VerifyTAPN { namespace DiscreteVerification {
 
-    class CoveredMarkingVisitor;
-
     template<typename T, typename M = NonStrictMarkingBase>
     class MarkingEncoder {
-        friend class CoveredMarkingVisitor;
-
         typedef binarywrapper_t<T> encoding_t;
 
     private:
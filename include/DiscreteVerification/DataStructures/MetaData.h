@@ -36,11 +36,9 @@ namespace DiscreteVerification {
 
     struct WorkflowSoundnessMetaData : public MetaData {
     public:
-        WorkflowSoundnessMetaData() : MetaData(), parents() { totalDelay = std::numeric_limits<int32_t>::max(); };
+        WorkflowSoundnessMetaData() : MetaData() { totalDelay = std::numeric_limits<int32_t>::max(); };
 
-        ~WorkflowSoundnessMetaData() override { parents.clear(); }
-
-        std::vector<MetaData *> parents;
+        uint32_t id{};  // state number assigned by the workflow analysis
     };
 
 
@@ -52,13 +50,9 @@ namespace DiscreteVerification {
     struct WorkflowSoundnessMetaDataWithEncoding : public MetaDataWithTraceAndEncoding {
     public:
         WorkflowSoundnessMetaDataWithEncoding()
-                : MetaDataWithTraceAndEncoding(), parents() { totalDelay = std::numeric_limits<int32_t>::max(); };
-
-        ~WorkflowSoundnessMetaDataWithEncoding() override {
-            parents.clear();
-        }
+                : MetaDataWithTraceAndEncoding() { totalDelay = std::numeric_limits<int32_t>::max(); };
 
-        std::vector<MetaData *> parents;
+        uint32_t id{};  // state number assigned by the workflow analysis
     };
 }
 }
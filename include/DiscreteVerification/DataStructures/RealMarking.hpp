@@ -82,12 +82,6 @@ namespace VerifyTAPN::DiscreteVerification {
                 return count;
             }
 
-            inline void deltaAge(double x) {
-                for(auto& token : tokens) {
-                    token.deltaAge(x);
-                }
-            }
-
             inline double maxTokenAge() const {
                 if(tokens.size() == 0) {
                     return -std::numeric_limits<double>::infinity();
@@ -95,6 +89,12 @@ namespace VerifyTAPN::DiscreteVerification {
                 return tokens.back().getAge();
             }
 
+            // Clock value of the owning marking at which the oldest token reaches the invariant of the place
+            inline double invariantDeadline() const {
+                if(tokens.size() == 0) return std::numeric_limits<double>::infinity();
+                return ((double) place->getInvariant().getBound()) - maxTokenAge();
+            }
+
             void add(RealToken new_token);
 
             void add(double age = 0.0f) {
@@ -103,12 +103,6 @@ namespace VerifyTAPN::DiscreteVerification {
 
             bool remove(RealToken to_remove);
 
-            double availableDelay() const {
-                if(tokens.size() == 0) return std::numeric_limits<double>::infinity();
-                double delay = ((double) place->getInvariant().getBound()) - maxTokenAge();
-                return delay <= 0.0f ? 0.0f : delay;
-            }
-
             inline int placeId() const {
                 return place->getIndex();
             }
@@ -121,19 +115,36 @@ namespace VerifyTAPN::DiscreteVerification {
 
     typedef std::vector<RealPlace> RealPlaceList;
 
+    /**
+     * Token ages are stored relative to a clock: the stored age of a token is the age it had when the clock was 0, its
+     * current age is getClock() plus the stored age (see getAge). A delay only moves the clock, so only firings
+     * touch the tokens. The token lists, the RealTokens added and removed, and maxTokenAge hold stored ages.
+     */
     class RealMarking {
 
         public:
 
             explicit RealMarking(TAPN::TimedArcPetriNet* net, NonStrictMarkingBase& base);
             RealMarking(const RealMarking& other);
+            // Unlike the copy constructor, also copies the generating transition and previous delay
+            RealMarking& operator=(const RealMarking& other);
 
             uint32_t size() const;
     
-            RealPlaceList& getPlaceList();
-            RealTokenList& getTokenList(int placeId);
+            // Changing tokens through the lists must be followed by tokensChanged()
+            inline RealPlaceList& getPlaceList() { return places; }
+            inline const RealPlaceList& getPlaceList() const { return places; }
+            inline RealTokenList& getTokenList(int placeId) { return places[placeId].tokens; }
+            inline const RealTokenList& getTokenList(int placeId) const { return places[placeId].tokens; }
+
+            inline void tokensChanged() { invariantDeadlineValid = false; }
+
+            // The clock is the date of the marking, set from the date of each step rather than summing delays
+            inline void setClock(double date) { clock = date; }
 
-            void deltaAge(double x);
+            inline double getClock() const { return clock; }
+
+            inline double getAge(const RealToken& token) const { return clock + token.getAge(); }
 
             NonStrictMarkingBase generateImage();
 
@@ -145,12 +156,14 @@ namespace VerifyTAPN::DiscreteVerification {
                 return canDeadlock(tapn, maxDelay, false);
             };
 
+            // Removes a token of the given stored age
             bool removeToken(int placeId, double age);
 
             bool removeToken(int placeId, RealToken &token);
 
             bool removeToken(RealPlace &place, RealToken &token);
 
+            // Adds a token of the given current age
             void addTokenInPlace(TAPN::TimedPlace &place, double age = 0.0f);
 
             void addTokenInPlace(RealPlace &place, RealToken &token);
@@ -159,6 +172,9 @@ namespace VerifyTAPN::DiscreteVerification {
 
             double availableDelay() const;
 
+            // Clock value from which the invariants forbid delaying
+            double getInvariantDeadline() const;
+
             void setDeadlocked(const bool dead);
 
             inline const TAPN::TimedTransition *getGeneratedBy() const { return generatedBy; }
@@ -175,6 +191,11 @@ namespace VerifyTAPN::DiscreteVerification {
 
             RealPlaceList places;
             bool deadlocked;
+            double clock = 0;
+
+            // Minimum invariantDeadline of the places, recomputed after the tokens have been changed
+            mutable double invariantDeadline = std::numeric_limits<double>::infinity();
+            mutable bool invariantDeadlineValid = false;
 
             const TAPN::TimedTransition *generatedBy = nullptr;
             double fromDelay = 0.0;
@@ -0,0 +1,44 @@
+/*
+ * ReverseEdgeStore.hpp
+ *
+ * Edges of an explored state space, kept for a backward reachability pass once the exploration is over.
+ */
+
+#ifndef REVERSEEDGESTORE_HPP_
+#define REVERSEEDGESTORE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace VerifyTAPN { namespace DiscreteVerification {
+
+    /**
+     * States are numbered 0, 1, ... by the caller. During the exploration the edges are only appended to a flat
+     * log; the backward pass sorts them by target into compressed arrays (an offset per state into one array of
+     * sources), so the predecessors of a state are contiguous and no per-state containers are allocated.
+     */
+    class ReverseEdgeStore {
+    public:
+        inline void addEdge(uint32_t source, uint32_t target) { edges.emplace_back(source, target); }
+
+        /**
+         * Sets reached[s] for every state s among the first states ones with a path to one of targets, and returns
+         * how many there are. The search goes backwards level by level; a level is split between up to threads
+         * threads when it is large enough.
+         */
+        size_t backwardReachable(size_t states, const std::vector<uint32_t> &targets, size_t threads,
+                                 std::vector<bool> &reached);
+
+    private:
+        void compress(size_t states);
+
+        std::vector<std::pair<uint32_t, uint32_t>> edges;   // (source, target), until compressed
+        std::vector<uint32_t> offsets;                      // sources of state s are [offsets[s], offsets[s + 1])
+        std::vector<uint32_t> sources;
+    };
+
+} } /* namespace VerifyTAPN */
+
+#endif /* REVERSEEDGESTORE_HPP_ */
@@ -0,0 +1,103 @@
+/*
+ * SMCTrace.hpp
+ *
+ * Compact record of a SMC run, replayed against the initial marking to print the run.
+ */
+
+#ifndef SMCTRACE_HPP
+#define SMCTRACE_HPP
+
+#include "DiscreteVerification/DataStructures/RealMarking.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace VerifyTAPN::DiscreteVerification {
+
+    struct SMCTraceStep {
+        double date; // date of the step, the delay before it is the difference with the previous date
+        int32_t transition; // index of the transition fired at the date, -1 if the step is only a delay
+        bool deadlocked; // deadlock flag of the marking the transition fired from
+    };
+
+    /**
+     * A run is stored as its steps and the stored ages (see RealMarking) of the tokens consumed by each firing, in the
+     * order of the transition's input arcs then transport arcs (weight tokens per arc), so that it can be replayed
+     * exactly, including the transport arcs and the random choice of tokens.
+     */
+    class SMCTrace {
+
+        public:
+
+            explicit SMCTrace(const RealMarking& initial) : initial(initial) { }
+
+            std::vector<SMCTraceStep> steps;
+            std::vector<double> consumed;
+            bool deadlocked = false; // deadlock flag of the last marking
+
+            /**
+             * Calls visit(old, marking) for every marking of the run: the initial marking, then for each firing the
+             * marking reached by the delays before it and the marking reached by firing it, and finally the last
+             * marking. Markings carry their previous delay, generating transition and deadlock flag; old is the marking
+             * the transition fired from when marking was generated by a transition, nullptr otherwise. Only the last
+             * two markings are kept in memory.
+             */
+            template<typename F>
+            void replay(const TAPN::TimedArcPetriNet& tapn, F&& visit) const {
+                RealMarking start(initial);
+                visit(nullptr, start);
+                RealMarking parent(initial);
+                size_t token = 0;
+                for(const SMCTraceStep& step : steps) {
+                    double delay = step.date - parent.getClock();
+                    parent.setClock(step.date);
+                    parent.setPreviousDelay(delay + parent.getPreviousDelay());
+                    if(step.transition < 0) continue;
+                    parent.setDeadlocked(step.deadlocked);
+                    visit(nullptr, parent);
+                    TAPN::TimedTransition* transition = tapn.getTransitions()[step.transition];
+                    RealMarking child(parent);
+                    token = fire(*transition, child, token);
+                    child.setGeneratedBy(transition);
+                    visit(&parent, child);
+                    parent = child;
+                    parent.setGeneratedBy(nullptr);
+                }
+                parent.setDeadlocked(deadlocked);
+                visit(nullptr, parent);
+            }
+
+        private:
+
+            // Fires transition on marking with the consumed tokens starting at token, returns the next token
+            size_t fire(const TAPN::TimedTransition& transition, RealMarking& marking, size_t token) const {
+                for(auto* input : transition.getPreset()) {
+                    for(uint32_t w = 0 ; w < input->getWeight() ; w++) {
+                        marking.removeToken(input->getInputPlace().getIndex(), consumed[token++]);
+                    }
+                }
+                std::vector<std::pair<const TAPN::TimedPlace*, RealToken>> toCreate;
+                for(auto* transport : transition.getTransportArcs()) {
+                    for(uint32_t w = 0 ; w < transport->getWeight() ; w++) {
+                        double age = consumed[token++];
+                        marking.removeToken(transport->getSource().getIndex(), age);
+                        toCreate.emplace_back(&transport->getDestination(), RealToken(age, 1));
+                    }
+                }
+                for(auto* output : transition.getPostset()) {
+                    RealToken created(-marking.getClock(), output->getWeight());
+                    marking.addTokenInPlace(output->getOutputPlace(), created);
+                }
+                for(auto& [place, created] : toCreate) {
+                    marking.addTokenInPlace(*place, created);
+                }
+                return token;
+            }
+
+            RealMarking initial;
+
+    };
+
+}
+
+#endif /* SMCTRACE_HPP */
@@ -0,0 +1,62 @@
+#ifndef STATESPACECACHE_HPP_
+#define STATESPACECACHE_HPP_
+
+#include "DiscreteVerification/DataStructures/NonStrictMarking.hpp"
+#include "Core/TAPN/TimedArcPetriNet.hpp"
+#include "Core/Query/AST.hpp"
+#include "Core/VerificationOptions.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace VerifyTAPN { namespace DiscreteVerification {
+
+    /**
+     * File backed copy of the passed list of a complete discrete exploration.
+     * The file is keyed by a hash of the (unfolded, initialized) net, the initial marking and the k-bound, so
+     * a later run on the same model can answer reachability queries by scanning the stored markings.
+     * Markings are stored with dead tokens kept, making the stored state-space independent of the query.
+     */
+    class StateSpaceCache {
+    public:
+        StateSpaceCache(const TAPN::TimedArcPetriNet &tapn, const std::vector<int> &initialPlacement,
+                        const VerificationOptions &options);
+
+        // true if the cache file exists and was written for the same net, initial marking and k-bound.
+        bool load();
+
+        void beginWrite();
+
+        void write(const NonStrictMarking &marking);
+
+        void endWrite(int maxTokens);
+
+        // true if some stored marking satisfies the query proposition (the negated one for AG).
+        bool find(AST::Query *query);
+
+        inline uint64_t size() const { return count; }
+
+        inline int maxUsedTokens() const { return maxTokens; }
+
+        inline const std::string &getFile() const { return file; }
+
+    private:
+        bool readHeader(std::ifstream &in);
+
+        void writeHeader();
+
+        inline std::string tmpFile() const { return file + ".tmp"; }
+
+        const TAPN::TimedArcPetriNet &tapn;
+        std::string file;
+        uint64_t key;
+        uint64_t count = 0;
+        int maxTokens = 0;
+        std::ofstream out;
+    };
+
+} }
+
+#endif /* STATESPACECACHE_HPP_ */
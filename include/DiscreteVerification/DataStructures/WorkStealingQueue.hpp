@@ -0,0 +1,82 @@
+/*
+ * WorkStealingQueue.hpp
+ *
+ * Shared frontier of a parallel exploration: one deque per worker, idle workers steal from the others.
+ */
+
+#ifndef WORKSTEALINGQUEUE_HPP_
+#define WORKSTEALINGQUEUE_HPP_
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace VerifyTAPN { namespace DiscreteVerification {
+
+    /**
+     * A worker pushes and pops at the back of its own deque (depth first, so the darts it just generated are
+     * still in cache) and steals from the front of the others, taking their oldest and typically largest pieces
+     * of work. The queue counts the items pushed but not finished yet: once it reaches zero no worker holds or can
+     * produce more work and the exploration is over.
+     */
+    template<typename T>
+    class WorkStealingQueue {
+    public:
+        explicit WorkStealingQueue(size_t workers) : _workers(workers), _deques(new Deque[workers]) {}
+
+        WorkStealingQueue(const WorkStealingQueue &) = delete;
+        WorkStealingQueue &operator=(const WorkStealingQueue &) = delete;
+
+        void push(size_t worker, T item) {
+            _pending.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> guard(_deques[worker].lock);
+            _deques[worker].items.push_back(std::move(item));
+        }
+
+        // Takes an item of worker's own deque, or steals one; every successful pop must be followed by finished.
+        bool pop(size_t worker, T &item) {
+            {
+                Deque &own = _deques[worker];
+                std::lock_guard<std::mutex> guard(own.lock);
+                if (!own.items.empty()) {
+                    item = std::move(own.items.back());
+                    own.items.pop_back();
+                    return true;
+                }
+            }
+            for (size_t i = 1; i < _workers; ++i) {
+                Deque &victim = _deques[(worker + i) % _workers];
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (!victim.items.empty()) {
+                    item = std::move(victim.items.front());
+                    victim.items.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Called when a popped item is processed, after its successors are pushed.
+        void finished() {
+            _pending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        bool empty() const {
+            return _pending.load(std::memory_order_acquire) == 0;
+        }
+
+    private:
+        struct alignas(64) Deque {
+            std::mutex lock;
+            std::deque<T> items;
+        };
+
+        size_t _workers;
+        std::unique_ptr<Deque[]> _deques;
+        std::atomic<size_t> _pending{0};
+    };
+
+} } /* namespace VerifyTAPN */
+
+#endif /* WORKSTEALINGQUEUE_HPP_ */
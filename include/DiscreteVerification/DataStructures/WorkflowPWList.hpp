@@ -13,7 +13,7 @@
 #include "NonStrictMarking.hpp"
 #include "WaitingList.hpp"
 #include "PWList.hpp"
-#include "CoveredMarkingVisitor.h"
+#include "CoveredMarkingIndex.hpp"
 
 #include <iostream>
 #include "google/sparse_hash_map"
@@ -23,13 +23,14 @@ namespace VerifyTAPN { namespace DiscreteVerification {
 
     class WorkflowPWListBasic : virtual public PWListBase {
     public:
-        virtual NonStrictMarking *getCoveredMarking(NonStrictMarking *marking, bool useLinearSweep) = 0;
+        // A stored marking covered by marking, see CoveredMarkingIndex; only tracked if the list was built with coverage.
+        virtual NonStrictMarking *getCoveredMarking(NonStrictMarking *marking) = 0;
 
         virtual NonStrictMarking *getUnpassed() = 0;
 
         bool add(NonStrictMarking *marking) override = 0;
 
-        virtual NonStrictMarking *addToPassed(NonStrictMarking *marking, bool strong) = 0;
+        virtual NonStrictMarking *addToPassed(NonStrictMarking *marking) = 0;
 
         virtual void addLastToWaiting() = 0;
 
@@ -39,16 +40,18 @@ namespace VerifyTAPN { namespace DiscreteVerification {
     class WorkflowPWList : public WorkflowPWListBasic, public PWList {
     private:
         NonStrictMarking *last{};
+        bool coverage;
+        CoveredMarkingIndex<NonStrictMarking *> coveredIndex;
     public:
-        explicit WorkflowPWList(WaitingList<NonStrictMarking *> *w_l);
+        WorkflowPWList(WaitingList<NonStrictMarking *> *w_l, bool coverage);
 
-        NonStrictMarking *getCoveredMarking(NonStrictMarking *marking, bool useLinearSweep) override;
+        NonStrictMarking *getCoveredMarking(NonStrictMarking *marking) override;
 
         NonStrictMarking *getUnpassed() override;
 
         bool add(NonStrictMarking *marking) override;
 
-        NonStrictMarking *addToPassed(NonStrictMarking *marking, bool strong) override;
+        NonStrictMarking *addToPassed(NonStrictMarking *marking) override;
 
         NonStrictMarking *lookup(NonStrictMarking *marking) override;
 
@@ -64,24 +67,26 @@ namespace VerifyTAPN { namespace DiscreteVerification {
 
     class WorkflowPWListHybrid : public WorkflowPWListBasic, public PWListHybrid {
     private:
-        CoveredMarkingVisitor visitor;
         ptriepointer_t<MetaData *> last_pointer;
+        bool coverage;
+        CoveredMarkingIndex<uint> coveredIndex; // markings by their index in passed
     public:
         WorkflowPWListHybrid(TAPN::TimedArcPetriNet &tapn,
                              WaitingList<ptriepointer_t<MetaData *> > *w_l,
                              int knumber,
                              int nplaces,
-                             int mage);
+                             int mage,
+                             bool coverage);
 
         ~WorkflowPWListHybrid() override;
 
-        NonStrictMarking *getCoveredMarking(NonStrictMarking *marking, bool useLinearSweep) override;
+        NonStrictMarking *getCoveredMarking(NonStrictMarking *marking) override;
 
         NonStrictMarking *getUnpassed() override;
 
         bool add(NonStrictMarking *marking) override;
 
-        NonStrictMarking *addToPassed(NonStrictMarking *marking, bool strong) override;
+        NonStrictMarking *addToPassed(NonStrictMarking *marking) override;
 
         void addLastToWaiting() override;
 
@@ -13,11 +13,15 @@
 #include "VerificationTypes/Verification.hpp"
 #include "VerificationTypes/LivenessSearch.hpp"
 #include "VerificationTypes/ReachabilitySearch.hpp"
+#include "VerificationTypes/SharedReachabilitySearch.hpp"
+#include "VerificationTypes/StateSpaceCacheSearch.hpp"
 #include "VerificationTypes/TimeDartReachabilitySearch.hpp"
+#include "VerificationTypes/ParallelTimeDartReachabilitySearch.hpp"
 #include "VerificationTypes/TimeDartLiveness.hpp"
 #include "VerificationTypes/WorkflowSoundness.hpp"
 #include "VerificationTypes/WorkflowStrongSoundness.hpp"
 #include "VerificationTypes/ProbabilityEstimation.hpp"
+#include "VerificationTypes/ProbabilitySplitting.hpp"
 #include "VerificationTypes/ProbabilityFloatComparison.hpp"
 #include "VerificationTypes/SMCTracesGenerator.hpp"
 #include "VerificationTypes/SMCVerification.hpp"
@@ -27,9 +31,6 @@
 #include "Core/Query/AST.hpp"
 #include "Core/VerificationOptions.hpp"
 
-#include <rapidxml.hpp>
-#include <rapidxml_print.hpp>
-
 #include <stack>
 #include <iostream>
 
@@ -45,6 +46,11 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         static int run(TAPN::TimedArcPetriNet &tapn, const std::vector<int>& initialPlacement, AST::Query *query,
                        VerificationOptions &options);
 
+        // Verifies a set of EF/AG queries using one shared exploration; results[i] holds the answer to queries[i].
+        static int run(TAPN::TimedArcPetriNet &tapn, const std::vector<int>& initialPlacement,
+                       const std::vector<AST::Query *> &queries, VerificationOptions &options,
+                       std::vector<bool> &results);
+
     };
 } }
 
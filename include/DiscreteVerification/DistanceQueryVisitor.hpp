@@ -0,0 +1,199 @@
+/*
+ * DistanceQueryVisitor.hpp
+ *
+ * Distance from a marking to the satisfaction of a query, used as score function by importance splitting.
+ */
+
+#ifndef DISTANCEQUERYVISITOR_HPP_
+#define DISTANCEQUERYVISITOR_HPP_
+
+#include "Core/Query/Visitor.hpp"
+#include "Core/Query/AST.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+
+namespace VerifyTAPN { namespace DiscreteVerification {
+
+    using namespace AST;
+
+    /**
+     * Like WeightQueryVisitor, the distance is the number of tokens to add or remove for the query to hold, but both
+     * the distance to true and to false are kept for every subformula so negations need no normalization. The distance
+     * is 0 exactly when the marking satisfies the query (as evaluated by QueryVisitor), and infinite (INT_MAX) when no
+     * marking can. The query's expressions are not written to, so several threads may share the query.
+     */
+    template<typename T>
+    class DistanceQueryVisitor : public Visitor {
+    public:
+        typedef SpecificResult<std::pair<int, int>> DistanceResult; // distances to true and to false
+
+        DistanceQueryVisitor(T &marking, const TAPN::TimedArcPetriNet &tapn) : marking(marking), tapn(tapn) { }
+
+        ~DistanceQueryVisitor() override = default;
+
+        int distance(Query &query) {
+            DistanceResult context;
+            query.accept(*this, context);
+            return context.value.first;
+        }
+
+    public: // visitor methods
+
+        void visit(NotExpression &expr, AST::Result &context) override;
+
+        void visit(OrExpression &expr, AST::Result &context) override;
+
+        void visit(AndExpression &expr, AST::Result &context) override;
+
+        void visit(AtomicProposition &expr, AST::Result &context) override;
+
+        void visit(BoolExpression &expr, AST::Result &context) override;
+
+        void visit(Query &query, AST::Result &context) override;
+
+        void visit(DeadlockExpression &expr, AST::Result &context) override;
+
+        void visit(NumberExpression &expr, AST::Result &context) override;
+
+        void visit(IdentifierExpression &expr, AST::Result &context) override;
+
+        void visit(MultiplyExpression &expr, AST::Result &context) override;
+
+        void visit(MinusExpression &expr, AST::Result &context) override;
+
+        void visit(SubtractExpression &expr, AST::Result &context) override;
+
+        void visit(PlusExpression &expr, AST::Result &context) override;
+
+    private:
+        static std::pair<int, int> compare(int numberOfTokensInPlace, AtomicProposition::op_e op, int n);
+
+        static inline int add(int a, int b) {
+            const int inf = std::numeric_limits<int>::max();
+            return (a == inf || b == inf || a > inf - b) ? inf : a + b;
+        }
+
+    private:
+        const T &marking;
+        const TAPN::TimedArcPetriNet &tapn;
+    };
+
+    template<typename T>
+    void DistanceQueryVisitor<T>::visit(NotExpression &expr, AST::Result &context) {
+        DistanceResult c;
+        expr.getChild().accept(*this, c);
+        static_cast<DistanceResult &>(context).value = { c.value.second, c.value.first };
+    }
+
+    template<typename T>
+    void DistanceQueryVisitor<T>::visit(OrExpression &expr, AST::Result &context) {
+        DistanceResult left, right;
+        expr.getLeft().accept(*this, left);
+        expr.getRight().accept(*this, right);
+        static_cast<DistanceResult &>(context).value = {
+                std::min(left.value.first, right.value.first), add(left.value.second, right.value.second) };
+    }
+
+    template<typename T>
+    void DistanceQueryVisitor<T>::visit(AndExpression &expr, AST::Result &context) {
+        DistanceResult left, right;
+        expr.getLeft().accept(*this, left);
+        expr.getRight().accept(*this, right);
+        static_cast<DistanceResult &>(context).value = {
+                add(left.value.first, right.value.first), std::min(left.value.second, right.value.second) };
+    }
+
+    template<typename T>
+    void DistanceQueryVisitor<T>::visit(AtomicProposition &expr, AST::Result &context) {
+        IntResult left;
+        expr.getLeft().accept(*this, left);
+        IntResult right;
+        expr.getRight().accept(*this, right);
+        static_cast<DistanceResult &>(context).value = compare(left.value, expr.getOperator(), right.value);
+    }
+
+    template<typename T>
+    void DistanceQueryVisitor<T>::visit(BoolExpression &expr, AST::Result &context) {
+        const int inf = std::numeric_limits<int>::max();
+        static_cast<DistanceResult &>(context).value = expr.getValue() ? std::make_pair(0, inf) : std::make_pair(inf, 0);
+    }
+
+    template<typename T>
+    void DistanceQueryVisitor<T>::visit(NumberExpression &expr, AST::Result &context) {
+        ((IntResult &) context).value = expr.getValue();
+    }
+
+    template<typename T>
+    void DistanceQueryVisitor<T>::visit(IdentifierExpression &expr, AST::Result &context) {
+        ((IntResult &) context).value = marking.numberOfTokensInPlace(expr.getPlace());
+    }
+
+    template<typename T>
+    void DistanceQueryVisitor<T>::visit(MultiplyExpression &expr, AST::Result &context) {
+        IntResult left;
+        expr.getLeft().accept(*this, left);
+        IntResult right;
+        expr.getRight().accept(*this, right);
+        ((IntResult &) context).value = left.value * right.value;
+    }
+
+    template<typename T>
+    void DistanceQueryVisitor<T>::visit(MinusExpression &expr, AST::Result &context) {
+        IntResult value;
+        expr.getValue().accept(*this, value);
+        ((IntResult &) context).value = -value.value;
+    }
+
+    template<typename T>
+    void DistanceQueryVisitor<T>::visit(SubtractExpression &expr, AST::Result &context) {
+        IntResult left;
+        expr.getLeft().accept(*this, left);
+        IntResult right;
+        expr.getRight().accept(*this, right);
+        ((IntResult &) context).value = left.value - right.value;
+    }
+
+    template<typename T>
+    void DistanceQueryVisitor<T>::visit(PlusExpression &expr, AST::Result &context) {
+        IntResult left;
+        expr.getLeft().accept(*this, left);
+        IntResult right;
+        expr.getRight().accept(*this, right);
+        ((IntResult &) context).value = left.value + right.value;
+    }
+
+    template<typename T>
+    void DistanceQueryVisitor<T>::visit(Query &query, AST::Result &context) {
+        query.getChild()->accept(*this, context);
+        // Same polarity as QueryVisitor: the distance is to a marking ending the run successfully
+        if (query.getQuantifier() == AG || query.getQuantifier() == AF || query.getQuantifier() == PG) {
+            auto &value = static_cast<DistanceResult &>(context).value;
+            value = { value.second, value.first };
+        }
+    }
+
+    template<typename T>
+    void DistanceQueryVisitor<T>::visit(DeadlockExpression &, AST::Result &context) {
+        bool deadlocked = marking.canDeadlock(tapn, 0);
+        static_cast<DistanceResult &>(context).value = deadlocked ? std::make_pair(0, 1) : std::make_pair(1, 0);
+    }
+
+    template<typename T>
+    std::pair<int, int> DistanceQueryVisitor<T>::compare(int numberOfTokensInPlace, AtomicProposition::op_e op, int n) {
+        const int diff = numberOfTokensInPlace - n;
+        switch(op) {
+            case AtomicProposition::LT: return diff < 0 ? std::make_pair(0, -diff) : std::make_pair(diff + 1, 0);
+            case AtomicProposition::LE: return diff <= 0 ? std::make_pair(0, 1 - diff) : std::make_pair(diff, 0);
+            case AtomicProposition::EQ: return diff == 0 ? std::make_pair(0, 1) : std::make_pair(abs(diff), 0);
+            case AtomicProposition::NE: return diff == 0 ? std::make_pair(1, 0) : std::make_pair(0, abs(diff));
+            default: assert(false);
+        }
+        return std::make_pair(0, 0);
+    }
+
+} } /* namespace VerifyTAPN */
+#endif /* DISTANCEQUERYVISITOR_HPP_ */
@@ -42,6 +42,12 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         virtual NonStrictMarkingBase *next(bool do_delay = true);
         
         void printTransitionStatistics(std::ostream &out) const;
+
+        // Statistics of generators that only fire some of the enabled transitions
+        virtual void printReductionStatistics(std::ostream &) const {}
+
+        // Adds the firings counted by other, a generator of the same net
+        void addTransitionStatistics(const Generator &other);
         
         const TAPN::TimedTransition *last_fired() const { return _last_fired; }
         
@@ -39,7 +39,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         friend class ReducingGenerator;
 
         explicit InterestingVisitor(const TAPN::TimedArcPetriNet &tapn)
-                : _incr(tapn.getPlaces().size()), _decr(tapn.getPlaces().size()) {
+                : _tapn(tapn), _incr(tapn.getPlaces().size()), _decr(tapn.getPlaces().size()) {
             _incr.shrink_to_fit();
             _decr.shrink_to_fit();
         };
@@ -76,16 +76,58 @@ namespace VerifyTAPN { namespace DiscreteVerification {
 
         void clear();
 
+        /**
+         * Query guided mode. An atom that must change its value only marks one place that has to change for it
+         * to do so: a place such that, while its number of tokens does not move in one direction, the atom keeps
+         * its value whatever the other places hold (between 0 and max_tokens, according to RangeVisitor). Among
+         * such places the one with the fewest transitions changing it is taken. Of the subformulas that each have
+         * to change (a false conjunct, a true disjunct under negation) the one marking the fewest transitions is
+         * taken. Atoms without such a place are marked syntactically.
+         */
+        void enable_guided(uint32_t max_tokens);
+
+        // Marking the atoms are evaluated in, needed in query guided mode.
+        void set_marking(NonStrictMarkingBase &marking) { _marking = &marking; }
+
         bool deadlock() const { return _deadlock; }
         
         bool increments(size_t p) const { return _incr[p]; }
         bool decrements(size_t p) const { return _decr[p]; }
         
     private:
+        struct Mark {
+            uint32_t place;
+            bool incr;
+        };
+
+        void mark(uint32_t place, bool incr);
+
+        // Marks a single place that must change for the atom to change its value; false if there is none.
+        bool guided(AtomicProposition &expr);
+
+        // The query visitor evaluates lazily, so the right operand of a decided and/or may hold a stale value.
+        bool evaluate(Expression &expr);
+
+        // Visits whichever of left and right marks the fewest transitions.
+        void cheapest(Expression &left, Expression &right, Result &context);
+
+        size_t cost_since(size_t first) const;
+
+        void rollback(size_t first);
+
+        const TAPN::TimedArcPetriNet &_tapn;
         bool _negated = false;
         bool _deadlock = false;
         std::vector<bool> _incr;
         std::vector<bool> _decr;
+        std::vector<Mark> _marks;   // set bits of _incr and _decr, in the order they were set
+
+        bool _guided = false;
+        bool _collect = false;      // identifiers only add their place to _places
+        NonStrictMarkingBase *_marking = nullptr;
+        std::vector<std::pair<uint32_t, uint32_t>> _bounds;
+        std::vector<uint32_t> _incr_cost, _decr_cost;
+        std::vector<uint32_t> _places;
     };    
 } }
 #endif /* INTERESTINGVISITOR_H */
@@ -12,6 +12,7 @@
 #include "StubbornSet.h"
 #include "DiscreteVerification/DataStructures/light_deque.h"
 #include "InterestingVisitor.h"
+#include "Core/VerificationOptions.hpp"
 
 namespace VerifyTAPN {
     namespace DiscreteVerification {
@@ -24,9 +25,19 @@ namespace VerifyTAPN {
             : Generator(tapn, query), _stubborn(tapn, query) {
             };
 
+            ReducingGenerator(TAPN::TimedArcPetriNet &tapn, AST::Query *query, const VerificationOptions &options)
+            : ReducingGenerator(tapn, query) {
+                if (options.getQueryGuidedReduction())
+                    _stubborn.enable_query_guided(options.getKBound());
+            };
+
             void prepare(NonStrictMarkingBase *parent) override;
 
             NonStrictMarkingBase *next(bool do_delay = true) override;
+
+            void printReductionStatistics(std::ostream &out) const override {
+                _stubborn.print_stats(out);
+            }
         };
 
     }
@@ -0,0 +1,151 @@
+/*
+ * File:   SMCBatchRunGenerator.h
+ *
+ * Simulates a batch of independent SMC runs in lockstep.
+ */
+
+#ifndef SMCBATCHRUNGENERATOR_H
+#define SMCBATCHRUNGENERATOR_H
+
+#include "DiscreteVerification/Generators/SMCRunGenerator.h"
+#include "Core/Query/AST.hpp"
+
+#include <cassert>
+
+namespace VerifyTAPN {
+    namespace DiscreteVerification {
+
+        struct SMCRunResult {
+            bool res;
+            int steps;
+            double duration;
+        };
+
+        /**
+         * Runs the same net as SMCRunGenerator, with the same semantics, but simulates one run per lane for a batch of
+         * lanes at once. The run state is stored as a structure of arrays with the lane as innermost index, so that
+         * drawing random numbers and finding the next event date of every lane are plain loops over contiguous
+         * memory; only firing a transition and refreshing its dependents is done lane by lane.
+         */
+        class SMCBatchRunGenerator {
+
+        public:
+
+            SMCBatchRunGenerator(TAPN::TimedArcPetriNet &tapn, size_t lanes, unsigned int numericPrecision = 0);
+
+            void prepare(RealMarking *initial);
+
+            // Lane l of stream s draws the numbers of a SMCRunGenerator with seed seed and stream s * lanes + l.
+            void setSeed(uint64_t seed, uint32_t stream = 0);
+
+            // Simulates runs runs until they reach the time or step bound, a maximal marking, or a marking satisfying
+            // query. results[i] is the result of the i-th started run, so a prefix of the results is an unbiased sample.
+            void simulate(AST::Query *query, int timeBound, int stepBound, size_t runs, std::vector<SMCRunResult> &results);
+
+            inline size_t lanes() const { return _lanes; }
+
+            inline uint32_t numberOfTokensInPlace(int place, size_t lane) const { return _tokens[place * _lanes + lane]; }
+
+            inline bool deadlocked(size_t lane) const { return _liveCount[lane] == 0; }
+
+            const std::vector<uint32_t>& getTransitionStatistics() const { return _transitionsStatistics; }
+
+        protected:
+
+            // UniformRandomBitGenerator reading the random numbers of one lane
+            struct LaneEngine {
+                typedef uint64_t result_type;
+                static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+                static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+                inline result_type operator()() { return generator.draw(lane); }
+                SMCBatchRunGenerator &generator;
+                size_t lane;
+            };
+
+            inline uint64_t draw(size_t lane) {
+                if(_randomUsed[lane] == _randomBlock) refillRandom();
+                return _random[_randomUsed[lane]++ * _lanes + lane];
+            }
+
+            void refillRandom();
+
+            void startRun(size_t lane, size_t run);
+            bool endRun(size_t lane, AST::Query *query, int timeBound, int stepBound, std::vector<SMCRunResult> &results);
+            void step(size_t lane);
+
+            void computeFiringWindows(size_t i, size_t lane);
+            void refreshTransition(size_t i, size_t lane, bool initial = false);
+            double sample(size_t i, size_t lane);
+            size_t chooseWeightedWinner(size_t lane);
+
+            void transitionFiringDates(TimedTransition* transi, size_t lane, std::vector<Util::interval<double>>& firingDates);
+            void arcFiringDates(const TimeInterval& time_interval, uint32_t weight, size_t place, size_t lane, std::vector<Util::interval<double>>& firingDates);
+            // Clock value from which the invariants of the lane's marking forbid delaying
+            double invariantDeadline(size_t lane) const;
+
+            void fire(TimedTransition* transi, size_t lane);
+            void removeTokens(size_t place, size_t lane, const TimeInterval& interval, int weight, SMC::FiringMode mode, std::vector<double>* removed = nullptr);
+            void removeRandom(size_t place, size_t lane, const TimeInterval& interval, int weight, std::vector<double>* removed);
+            void removeSlot(size_t place, size_t lane, size_t slot);
+            void addToken(size_t place, size_t lane, double age);
+            void reserveSlots(size_t place, size_t slots);
+
+            TAPN::TimedArcPetriNet &_tapn;
+            const size_t _lanes;
+            const unsigned int _numericPrecision;
+            std::vector<std::vector<uint32_t>> _affectedBy;
+            std::vector<bool> _touchesInvariant;
+            std::vector<uint32_t> _transitionsStatistics;
+
+            // Initial marking (ages of each place, oldest first) and the firing windows it gives
+            std::vector<std::vector<double>> _initialAges;
+            std::vector<double> _defaultLower, _defaultUpper, _defaultNext;
+            double _initialDeadline = 0;
+
+            // Per lane
+            std::vector<double> _clock;
+            std::vector<double> _deadline; // absolute time at which the invariants block further delays
+            std::vector<double> _nextDate;
+            std::vector<int> _steps;
+            std::vector<uint32_t> _liveCount;
+            std::vector<uint8_t> _active;
+            std::vector<size_t> _run; // index of the run simulated by the lane
+
+            // Per transition and lane, at index transition * lanes + lane. Like in SMCRunGenerator the windows are
+            // absolute, but only the first one and the start of the second one are kept; the windows are recomputed
+            // when the first one has expired.
+            std::vector<double> _lower, _upper, _nextLower;
+            std::vector<double> _dates; // sampled firing dates, absolute
+            std::vector<double> _keys; // next date at which the transition fires or its window opens/closes
+            std::vector<uint8_t> _live;
+
+            // Stored token ages of each place at index slot * lanes + lane, every lane sorted oldest first. As in
+            // RealMarking, the age of a token is the lane clock plus its stored age, so delays leave the tokens untouched.
+            std::vector<std::vector<double>> _ages;
+            std::vector<size_t> _slots;
+            std::vector<uint32_t> _tokens; // place * lanes + lane
+
+            Util::Xoshiro256PlusPlusLanes _rng;
+            const uint32_t _randomBlock = 16;
+            std::vector<uint64_t> _random; // block of random numbers, at index k * lanes + lane
+            std::vector<uint32_t> _randomUsed;
+
+            // Scratch buffers, see SMCRunGenerator
+            std::vector<Util::interval<double>> _windows;
+            std::vector<Util::interval<double>> _arcDates;
+            std::vector<Util::interval<double>> _intersection;
+            std::vector<size_t> _due;
+            std::vector<size_t> _winners;
+            std::vector<size_t> _infiniteWinners;
+            std::vector<double> _consumed;
+            std::vector<std::pair<size_t, double>> _toCreate;
+            RealTokenList _packets;
+            std::vector<uint32_t> _refreshed;
+            uint32_t _refreshStamp = 0;
+
+        };
+
+    }
+}
+
+#endif /* SMCBATCHRUNGENERATOR_H */
@@ -10,13 +10,39 @@
 
 #include "DiscreteVerification/Generators/Generator.h"
 #include "DiscreteVerification/Util/IntervalOps.hpp"
+#include "DiscreteVerification/Util/Xoshiro256.hpp"
+#include "DiscreteVerification/Util/IndexedMinHeap.hpp"
 #include "Core/Query/SMCQuery.hpp"
 #include "DiscreteVerification/DataStructures/RealMarking.hpp"
+#include "DiscreteVerification/DataStructures/SMCTrace.hpp"
 #include "Core/TAPN/StochasticStructure.hpp"
 
+#include <optional>
+
 namespace VerifyTAPN {
     namespace DiscreteVerification {
 
+        // Engine used for all sampling during runs; any UniformRandomBitGenerator can be plugged in here
+        // (seedEngine must then be overloaded if it cannot be seeded from a std::seed_seq).
+        typedef Util::Xoshiro256PlusPlus SMCRandomEngine;
+
+        // Run state of a SMCRunGenerator (marking, firing windows, sampled dates, clock), from which the run can be
+        // continued any number of times, see SMCRunGenerator::saveState.
+        struct SMCRunState {
+            explicit SMCRunState(const RealMarking& marking) : marking(marking) { }
+
+            RealMarking marking;
+            std::vector<std::vector<Util::interval<double>>> transitionIntervals;
+            std::vector<double> datesSampled;
+            double deadline = 0;
+            Util::IndexedMinHeap events;
+            std::vector<bool> live;
+            size_t liveCount = 0;
+            bool maximal = false;
+            double totalTime = 0;
+            int totalSteps = 0;
+        };
+
         class SMCRunGenerator {
 
         public:
@@ -28,17 +54,13 @@ namespace VerifyTAPN {
             , _numericPrecision(numericPrecision)
             {
                 std::random_device rd;
-                _rng = std::ranlux48(rd());
+                seedEngine(_rng, ((uint64_t) rd() << 32) | rd(), 0);
+                buildDependencies();
             };
 
             ~SMCRunGenerator() {
                 delete _origin;
-                if(_trace.size() > 0) {
-                    for(RealMarking* marking : _trace) {
-                        if(marking != nullptr) delete marking;
-                    }
-                }
-                else if(_parent != nullptr) delete _parent;
+                delete _parent;
             }
 
             virtual void prepare(RealMarking *parent);
@@ -47,22 +69,48 @@ namespace VerifyTAPN {
 
             SMCRunGenerator copy() const;
 
+            // Snapshot of the current run, and continuation of a snapshot taken on a generator of the same net. The
+            // random engine is not part of the state, so continuations of the same snapshot diverge. Traces are not
+            // supported.
+            SMCRunState saveState() const;
+            void restoreState(const SMCRunState& state);
+
+            template<typename E>
+            static void seedEngine(E& engine, uint64_t seed, uint32_t stream) {
+                std::seed_seq seq { (uint32_t) seed, (uint32_t) (seed >> 32), stream };
+                engine.seed(seq);
+            }
+
+            static void seedEngine(Util::Xoshiro256PlusPlus& engine, uint64_t seed, uint32_t stream) {
+                engine.seed(seed);
+                for(uint32_t i = 0 ; i < stream ; i++) engine.jump();
+            }
+
+            // Reseeds the generator; different streams of the same seed give independent, reproducible runs.
+            void setSeed(uint64_t seed, uint32_t stream = 0);
+
             RealMarking* getMarking() { return _parent; }
 
-            void refreshTransitionsIntervals();
+            void refreshTransition(size_t i, bool initial = false);
 
             void disableTransitions(RealMarking* marking);
 
-            std::vector<Util::interval<double>> transitionFiringDates(TimedTransition* transi);
-            std::vector<Util::interval<double>> arcFiringDates(TimeInterval time_interval, uint32_t weight, RealTokenList& tokens);
+            // Results are written to the given vector (cleared first), so the buffers can be reused across steps.
+            void transitionFiringDates(TimedTransition* transi, std::vector<Util::interval<double>>& firingDates);
+            // tokens hold stored ages (see RealMarking) and the marking clock is the run date, so a token has a given
+            // age at that age minus its stored age. Only dates from now on are kept.
+            void arcFiringDates(TimeInterval time_interval, uint32_t weight, RealTokenList& tokens, double now, std::vector<Util::interval<double>>& firingDates);
             
-            std::vector<RealToken> removeRandom(RealTokenList& tokenlist, const TimeInterval& interval, const int weight);
-            std::vector<RealToken> removeYoungest(RealTokenList& tokenlist, const TimeInterval& interval, const int weight);
-            std::vector<RealToken> removeOldest(RealTokenList& tokenlist, const TimeInterval& interval, const int weight);
+            // The removed tokens are appended to removed, if given, with their stored ages.
+            void removeRandom(RealTokenList& tokenlist, double clock, const TimeInterval& interval, const int weight, std::vector<RealToken>* removed = nullptr);
+            void removeYoungest(RealTokenList& tokenlist, double clock, const TimeInterval& interval, const int weight, std::vector<RealToken>* removed = nullptr);
+            void removeOldest(RealTokenList& tokenlist, double clock, const TimeInterval& interval, const int weight, std::vector<RealToken>* removed = nullptr);
 
             std::pair<TimedTransition*, double> getWinnerTransitionAndDelay();
 
-            RealMarking* fire(TimedTransition* transi);
+            // Fires transi in place on marking. The stored ages of the consumed tokens are appended to consumed, if
+            // given, one per token in the order of the input arcs then the transport arcs.
+            void fire(TimedTransition* transi, RealMarking& marking, std::vector<double>* consumed = nullptr);
 
             bool reachedEnd() const;
 
@@ -70,32 +118,66 @@ namespace VerifyTAPN {
             int getRunSteps() const;
 
             void printTransitionStatistics(std::ostream &out) const;
+            void addTransitionStatistics(const std::vector<uint32_t>& statistics);
+
+            // Transitions whose firing windows must be recomputed after firing each transition, and the transitions
+            // whose firing changes a place with an invariant.
+            static void computeDependencies(TimedArcPetriNet& tapn, std::vector<std::vector<uint32_t>>& affectedBy, std::vector<bool>& touchesInvariant);
 
-            std::stack<RealMarking*> getTrace() const;
+            // Whether a token of the given stored age (see RealMarking) can be consumed through interval at date now.
+            // The test is on dates, computed as in arcFiringDates, so a transition fired within its firing window
+            // always finds its tokens; testing now plus the stored age would round differently.
+            static inline bool consumable(const TimeInterval& interval, double storedAge, double now) {
+                return now >= interval.getLowerBound() - storedAge && now <= interval.getUpperBound() - storedAge;
+            }
+
+            // The run since the last reset, if recordTrace is set.
+            SMCTrace getTrace() const;
 
             bool recordTrace = false;
             
         protected:
         
             TimedTransition* chooseWeightedWinner(const std::vector<size_t>& winner_indexs);
+
+            void buildDependencies();
+            void computeFiringWindows(size_t i);
             
             bool _maximal = false;
             TimedArcPetriNet& _tapn;
+            // Firing windows are kept in absolute run time and are not clipped by invariants, so a window only has to be
+            // recomputed when a firing changes the tokens in one of the transition's input or inhibitor places.
             std::vector<std::vector<Util::interval<double>>> _defaultTransitionIntervals; // Type not pretty, but need disjoint intervals
             std::vector<std::vector<Util::interval<double>>> _transitionIntervals; // Type not pretty, but need disjoint intervals
-            std::vector<double> _dates_sampled;
+            std::vector<double> _dates_sampled; // absolute
+            double _deadline = 0; // absolute time at which the invariants block further delays
+            Util::IndexedMinHeap _events; // next date at which each transition fires or its window opens/closes
+            std::vector<std::vector<uint32_t>> _affectedBy; // transitions whose windows depend on places changed by firing
+            std::vector<bool> _touchesInvariant;
+            std::vector<bool> _live;
+            size_t _liveCount = 0;
+            std::vector<size_t> _due;
+            std::vector<size_t> _winners;
+            std::vector<size_t> _infiniteWinners;
+            // Scratch buffers for computing firing windows and firing, kept to avoid allocations in the step loop
+            std::vector<Util::interval<double>> _arcDates;
+            std::vector<Util::interval<double>> _intersection;
+            std::vector<RealToken> _consumed;
+            std::vector<std::pair<const TimedPlace*, RealToken>> _toCreate;
+            std::vector<uint32_t> _refreshed;
+            uint32_t _refreshStamp = 0;
             std::vector<uint32_t> _transitionsStatistics;
-            RealMarking* _origin;
-            RealMarking* _parent;
+            RealMarking* _origin = nullptr;
+            RealMarking* _parent = nullptr; // the live marking, fired in place
             double _lastDelay = 0;
             double _totalTime = 0;
             int _totalSteps = 0;
 
             unsigned int _numericPrecision = 0;
 
-            std::ranlux48 _rng;
+            SMCRandomEngine _rng;
 
-            std::vector<RealMarking*> _trace;
+            std::optional<SMCTrace> _trace;
             
         };
 
@@ -9,6 +9,7 @@
 #define STUBBORNSET_H
 
 #include "DiscreteVerification/DataStructures/light_deque.h"
+#include "DiscreteVerification/Util/ClearableBitset.hpp"
 
 #include "InterestingVisitor.h"
 #include "NextEnabledGenerator.h"
@@ -23,6 +24,9 @@ namespace VerifyTAPN {
             const TimedTransition* pop_next();
             bool urgent() const { return _urgent_enabled; }
             bool irreducable() const { return !_can_reduce; }
+            // see InterestingVisitor::enable_guided
+            void enable_query_guided(uint32_t max_tokens) { _interesting.enable_guided(max_tokens); }
+            void print_stats(std::ostream& out) const;
         protected:
             const TimedArcPetriNet& _tapn;
             AST::Query* _query;
@@ -30,12 +34,39 @@ namespace VerifyTAPN {
             NonStrictMarkingBase* _parent;
             bool _can_reduce = false;
         private:
+            // Relation from places or transitions to lists of entries, stored as one array with an offset per index.
+            template<typename T>
+            struct Relation {
+                std::vector<uint32_t> offsets{0};
+                std::vector<T> entries;
+
+                void close() { offsets.push_back(entries.size()); }
+                const T* begin(size_t i) const { return entries.data() + offsets[i]; }
+                const T* end(size_t i) const { return entries.data() + offsets[i + 1]; }
+            };
+
+            struct GuardedTransition {
+                uint32_t transition;
+                const TAPN::TimeInterval* interval;
+            };
+
+            void compute_dependencies();
+
             NextEnabledGenerator _gen_enabled;
             InterestingVisitor _interesting;
-            std::vector<bool> _enabled, _stubborn;
+            Util::ClearableBitset _enabled, _stubborn;
+            // static dependencies, computed once from the net
+            Relation<uint32_t> _increasing;             // place -> transitions that can add tokens to it
+            Relation<GuardedTransition> _decreasing;    // place -> transitions that can remove tokens from it
+            Relation<uint32_t> _inhibited;              // place -> transitions with an inhibitor arc from it
+            Relation<uint32_t> _consumed;               // transition -> places it removes tokens from
+            Relation<uint32_t> _interfering;            // transition -> transitions its firing may disable
             light_deque<uint32_t> _unprocessed;
             bool _urgent_enabled = false;
             bool _added_zt;
+            size_t _num_enabled = 0;
+            // reduction statistics over the prepared markings
+            size_t _markings = 0, _reduced = 0, _enabled_total = 0, _stubborn_total = 0;
             
         protected:
             virtual bool urgent_priority(const TimedTransition* urg_trans, const TimedTransition* trans) const;
@@ -53,6 +84,8 @@ namespace VerifyTAPN {
 
             void postset_of(size_t i, const TAPN::TimeInterval &interval = TAPN::TimeInterval());
 
+            void check_zero_time(size_t i);
+
             void inhib_postset_of(size_t i);
 
             bool zero_time_set(int32_t max_age, const TAPN::TimedPlace *, const TAPN::TimedTransition *);
@@ -64,8 +97,8 @@ namespace VerifyTAPN {
             void set_stubborn(const TAPN::TimedTransition& trans) { set_stubborn(trans.getIndex()); }
             void set_stubborn(const TAPN::TimedTransition *trans) { set_stubborn(trans->getIndex()); }
             void set_stubborn(size_t t, bool add_to_working = true);            
-            bool is_stubborn(size_t t) const { return _stubborn[t]; }
-            virtual bool is_enabled(size_t t) const { return _enabled[t]; }
+            bool is_stubborn(size_t t) const { return _stubborn.test(t); }
+            virtual bool is_enabled(size_t t) const { return _enabled.test(t); }
         };
     }
 }
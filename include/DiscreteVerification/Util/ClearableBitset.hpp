@@ -0,0 +1,46 @@
+#ifndef CLEARABLEBITSET_HPP_
+#define CLEARABLEBITSET_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VerifyTAPN {
+    namespace DiscreteVerification {
+        namespace Util {
+
+            /**
+             * Bitset over [0, n) that remembers which words it has touched, so clearing costs the number of bits
+             * set since the last clear rather than n.
+             */
+            class ClearableBitset {
+            public:
+                explicit ClearableBitset(size_t n = 0) : _words((n + 63) / 64, 0) {}
+
+                inline bool test(size_t i) const { return (_words[i / 64] >> (i % 64)) & 1; }
+
+                // Sets bit i; returns false if it was already set.
+                inline bool set(size_t i) {
+                    uint64_t &word = _words[i / 64];
+                    uint64_t bit = uint64_t(1) << (i % 64);
+                    if (word & bit) return false;
+                    if (word == 0) _touched.push_back(i / 64);
+                    word |= bit;
+                    return true;
+                }
+
+                void clear() {
+                    for (auto w : _touched) _words[w] = 0;
+                    _touched.clear();
+                }
+
+            private:
+                std::vector<uint64_t> _words;
+                std::vector<uint32_t> _touched;
+            };
+
+        } /* namespace Util */
+    } /* namespace DiscreteVerification */
+} /* namespace VerifyTAPN */
+
+#endif /* CLEARABLEBITSET_HPP_ */
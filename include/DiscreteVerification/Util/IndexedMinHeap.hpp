@@ -0,0 +1,108 @@
+#ifndef INDEXEDMINHEAP_HPP_
+#define INDEXEDMINHEAP_HPP_
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace VerifyTAPN {
+    namespace DiscreteVerification {
+        namespace Util {
+
+            /**
+             * Binary min-heap over the fixed index set [0, n) with updatable keys.
+             * Every index is always present; an index without a pending event has key infinity.
+             */
+            class IndexedMinHeap {
+            public:
+                explicit IndexedMinHeap(size_t n = 0) { resize(n); }
+
+                void resize(size_t n) {
+                    _keys.assign(n, std::numeric_limits<double>::infinity());
+                    _heap.resize(n);
+                    _pos.resize(n);
+                    for (size_t i = 0; i < n; ++i) {
+                        _heap[i] = i;
+                        _pos[i] = i;
+                    }
+                }
+
+                // Resets all keys to infinity, keeping the index set.
+                void clear() {
+                    for (auto &key : _keys) key = std::numeric_limits<double>::infinity();
+                }
+
+                inline size_t size() const { return _keys.size(); }
+
+                inline double key(size_t i) const { return _keys[i]; }
+
+                inline size_t top() const { return _heap[0]; }
+
+                inline double topKey() const {
+                    return _heap.empty() ? std::numeric_limits<double>::infinity() : _keys[_heap[0]];
+                }
+
+                void update(size_t i, double key) {
+                    double old = _keys[i];
+                    _keys[i] = key;
+                    if (key < old) siftUp(_pos[i]);
+                    else if (key > old) siftDown(_pos[i]);
+                }
+
+                // Calls f(i) for every index whose key equals the minimum, visiting only the matching part of the heap.
+                template<typename F>
+                void forEachMinimum(F &&f) const {
+                    if (_heap.empty()) return;
+                    double min = topKey();
+                    visit(0, min, f);
+                }
+
+            private:
+                template<typename F>
+                void visit(size_t node, double min, F &f) const {
+                    if (node >= _heap.size() || _keys[_heap[node]] != min) return;
+                    f(_heap[node]);
+                    visit(2 * node + 1, min, f);
+                    visit(2 * node + 2, min, f);
+                }
+
+                void siftUp(size_t node) {
+                    size_t index = _heap[node];
+                    while (node > 0) {
+                        size_t parent = (node - 1) / 2;
+                        if (_keys[_heap[parent]] <= _keys[index]) break;
+                        place(node, _heap[parent]);
+                        node = parent;
+                    }
+                    place(node, index);
+                }
+
+                void siftDown(size_t node) {
+                    size_t index = _heap[node];
+                    size_t n = _heap.size();
+                    while (true) {
+                        size_t child = 2 * node + 1;
+                        if (child >= n) break;
+                        if (child + 1 < n && _keys[_heap[child + 1]] < _keys[_heap[child]]) child++;
+                        if (_keys[index] <= _keys[_heap[child]]) break;
+                        place(node, _heap[child]);
+                        node = child;
+                    }
+                    place(node, index);
+                }
+
+                inline void place(size_t node, size_t index) {
+                    _heap[node] = index;
+                    _pos[index] = node;
+                }
+
+                std::vector<double> _keys;
+                std::vector<size_t> _heap;
+                std::vector<size_t> _pos;
+            };
+
+        }
+    }
+}
+
+#endif /* INDEXEDMINHEAP_HPP_ */
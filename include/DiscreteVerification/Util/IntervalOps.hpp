@@ -11,6 +11,7 @@
 #include <vector>
 #include <limits>
 #include <iostream>
+#include <boost/container/small_vector.hpp>
 
 namespace VerifyTAPN {
     namespace DiscreteVerification {
@@ -122,12 +123,12 @@ namespace VerifyTAPN {
             }
 
             template<typename T = int>
-            std::vector<interval<T>> setIntersection(const std::vector<interval<T>> &first,
-                                                  const std::vector<interval<T>> &second) {
-                std::vector<interval<T>> result;
+            void setIntersection(const std::vector<interval<T>> &first, const std::vector<interval<T>> &second,
+                                 std::vector<interval<T>> &result) {
+                result.clear();
 
                 if (first.empty() || second.empty()) {
-                    return result;
+                    return;
                 }
 
                 unsigned int i = 0, j = 0;
@@ -150,9 +151,41 @@ namespace VerifyTAPN {
                         j++;
                     }
                 }
+            }
+
+            template<typename T = int>
+            std::vector<interval<T>> setIntersection(const std::vector<interval<T>> &first,
+                                                  const std::vector<interval<T>> &second) {
+                std::vector<interval<T>> result;
+                setIntersection(first, second, result);
                 return result;
             }
 
+            // Sorted, disjoint intervals, kept on the stack while there are at most N of them
+            template<typename T = int, size_t N = 8>
+            using small_interval_set = boost::container::small_vector<interval<T>, N>;
+
+            // setIntersection for any container of sorted, disjoint intervals
+            template<typename S>
+            void setIntersectionOf(const S &first, const S &second, S &result) {
+                result.clear();
+                size_t i = 0, j = 0;
+                while (i < first.size() && j < second.size()) {
+                    auto intersection = intersect(first[i], second[j]);
+                    if (!intersection.empty()) {
+                        result.push_back(intersection);
+                    }
+                    auto i1up = first[i].upper();
+                    auto i2up = second[j].upper();
+                    if (i1up <= i2up) {
+                        i++;
+                    }
+                    if (i2up <= i1up) {
+                        j++;
+                    }
+                }
+            }
+
             template<typename T = int>
             std::vector<interval<T>> complement(const interval<T> &element) {
                 const T min_infty = interval<T>::boundDown();
@@ -0,0 +1,84 @@
+/*
+ * RunStatistics.hpp
+ *
+ * Constant-memory accumulators for the statistics of SMC runs.
+ */
+
+#ifndef RUNSTATISTICS_HPP_
+#define RUNSTATISTICS_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+namespace VerifyTAPN {
+    namespace DiscreteVerification {
+        namespace Util {
+
+            // Count, mean and standard deviation of a stream of values (Welford's algorithm)
+            class RunningStatistics {
+            public:
+                inline void add(double value) {
+                    _count++;
+                    double delta = value - _mean;
+                    _mean += delta / _count;
+                    _m2 += delta * (value - _mean);
+                }
+
+                inline unsigned long count() const { return _count; }
+
+                inline double mean() const { return _mean; }
+
+                // Population standard deviation
+                inline double stdDev() const { return _count > 0 ? sqrt(_m2 / _count) : 0; }
+
+            private:
+                unsigned long _count = 0;
+                double _mean = 0;
+                double _m2 = 0;
+            };
+
+            /**
+             * Counts of non-negative values in a fixed number of equal bins covering [0, range). When a value beyond
+             * the range is added, the range doubles and every pair of bins is merged, so the memory does not depend on
+             * the number or the magnitude of the values.
+             */
+            class StreamingHistogram {
+            public:
+                explicit StreamingHistogram(size_t bins = 4096, double range = 1)
+                : _counts(std::max<size_t>(2, bins + bins % 2), 0), _range(range) { }
+
+                void add(double value) {
+                    while(value >= _range) grow();
+                    size_t bin = std::min((size_t) (value / width()), _counts.size() - 1);
+                    _counts[bin]++;
+                }
+
+                inline size_t bins() const { return _counts.size(); }
+
+                inline double width() const { return _range / _counts.size(); }
+
+                inline unsigned long count(size_t bin) const { return _counts[bin]; }
+
+                inline double center(size_t bin) const { return (bin + 0.5) * width(); }
+
+            private:
+                void grow() {
+                    const size_t half = _counts.size() / 2;
+                    for(size_t i = 0 ; i < half ; i++) {
+                        _counts[i] = _counts[2 * i] + _counts[2 * i + 1];
+                    }
+                    std::fill(_counts.begin() + half, _counts.end(), 0);
+                    _range *= 2;
+                }
+
+                std::vector<unsigned long> _counts;
+                double _range;
+            };
+
+        }
+    }
+}
+
+#endif /* RUNSTATISTICS_HPP_ */
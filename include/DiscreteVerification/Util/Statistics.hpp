@@ -0,0 +1,87 @@
+/*
+ * Statistics.hpp
+ *
+ * Quantiles used by the SMC estimators to compute confidence intervals.
+ */
+
+#ifndef STATISTICS_HPP_
+#define STATISTICS_HPP_
+
+#include <cmath>
+
+namespace VerifyTAPN {
+    namespace DiscreteVerification {
+        namespace Util {
+
+            // Inverse of the standard normal cumulative distribution function, by bisection
+            inline double inverseNormal(double p) {
+                double low = -40, high = 40;
+                for(int i = 0 ; i < 200 && high - low > 1e-12 ; i++) {
+                    double mid = (low + high) / 2;
+                    if(0.5 * erfc(-mid / sqrt(2.0)) < p) low = mid;
+                    else high = mid;
+                }
+                return (low + high) / 2;
+            }
+
+            // Regularized incomplete beta function I_x(a, b), continued fraction from Numerical Recipes (6.4)
+            inline double incompleteBeta(double x, double a, double b) {
+                if(x <= 0) return 0;
+                if(x >= 1) return 1;
+                if(x > (a + 1) / (a + b + 2)) return 1 - incompleteBeta(1 - x, b, a);
+                const double tiny = 1e-300;
+                double front = exp(lgamma(a + b) - lgamma(a) - lgamma(b) + a * log(x) + b * log(1 - x)) / a;
+                double c = 1, d = 1 - (a + b) * x / (a + 1);
+                if(fabs(d) < tiny) d = tiny;
+                d = 1 / d;
+                double f = d;
+                for(int m = 1 ; m < 100000 ; m++) {
+                    double num = m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m));
+                    d = 1 + num * d;
+                    if(fabs(d) < tiny) d = tiny;
+                    c = 1 + num / c;
+                    if(fabs(c) < tiny) c = tiny;
+                    d = 1 / d;
+                    f *= c * d;
+                    num = -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));
+                    d = 1 + num * d;
+                    if(fabs(d) < tiny) d = tiny;
+                    c = 1 + num / c;
+                    if(fabs(c) < tiny) c = tiny;
+                    d = 1 / d;
+                    double delta = c * d;
+                    f *= delta;
+                    if(fabs(delta - 1) < 1e-12) break;
+                }
+                return front * f;
+            }
+
+            // Quantile of the Beta(a, b) distribution, by bisection
+            inline double inverseBeta(double p, double a, double b) {
+                double low = 0, high = 1;
+                for(int i = 0 ; i < 60 ; i++) {
+                    double mid = (low + high) / 2;
+                    if(incompleteBeta(mid, a, b) < p) low = mid;
+                    else high = mid;
+                }
+                return (low + high) / 2;
+            }
+
+            // Quantile of the Student t distribution with dof degrees of freedom, for p >= 0.5, by bisection on
+            // P(|T| > t) = I_{dof / (dof + t^2)}(dof / 2, 1 / 2)
+            inline double inverseStudent(double p, double dof) {
+                double tail = 2 * (1 - p);
+                double low = 0, high = 1e6;
+                for(int i = 0 ; i < 200 && high - low > 1e-12 ; i++) {
+                    double mid = (low + high) / 2;
+                    if(incompleteBeta(dof / (dof + mid * mid), dof / 2, 0.5) > tail) low = mid;
+                    else high = mid;
+                }
+                return (low + high) / 2;
+            }
+
+        }
+    }
+}
+
+#endif /* STATISTICS_HPP_ */
@@ -0,0 +1,75 @@
+/*
+ * XMLTraceWriter.hpp
+ *
+ * Streaming writer for the XML traces, formatted exactly as rapidxml prints a document.
+ */
+
+#ifndef XMLTRACEWRITER_HPP_
+#define XMLTRACEWRITER_HPP_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace VerifyTAPN {
+    namespace DiscreteVerification {
+        namespace Util {
+
+            /**
+             * Writes elements as they are produced instead of building a DOM first. The output is buffered and written
+             * to the stream in large blocks. The start tag of an element is only completed when its first child or
+             * its end is written, so childless elements print as <name/> like in rapidxml.
+             *
+             * One element can be held back with pendingElement: it is written before anything else is, unless it is
+             * dropped by discardPending first (used to remove a trailing delay).
+             */
+            class XMLTraceWriter {
+            public:
+                explicit XMLTraceWriter(std::ostream& out) : _out(out) { }
+
+                ~XMLTraceWriter() { flush(); }
+
+                XMLTraceWriter(const XMLTraceWriter&) = delete;
+                XMLTraceWriter& operator=(const XMLTraceWriter&) = delete;
+
+                void startElement(const std::string& name);
+
+                // Only valid right after startElement or another attribute
+                void attribute(const std::string& name, const std::string& value);
+
+                void endElement();
+
+                // Element containing only text, or nothing if value is empty
+                void element(const std::string& name, const std::string& value = "");
+
+                void pendingElement(const std::string& name, const std::string& value = "");
+
+                void discardPending();
+
+                // Closes the open elements and ends the document
+                void endDocument();
+
+                void flush();
+
+            private:
+                void writePending();
+                void closeStartTag();
+                void indent(size_t depth);
+                void escaped(const std::string& value, char noexpand);
+                void write(const std::string& value);
+                void write(char c);
+
+                std::ostream& _out;
+                std::string _buffer;
+                std::vector<std::string> _open;
+                bool _inStartTag = false;
+                bool _hasPending = false;
+                std::string _pendingName;
+                std::string _pendingValue;
+            };
+
+        }
+    }
+}
+
+#endif /* XMLTRACEWRITER_HPP_ */
@@ -0,0 +1,134 @@
+#ifndef XOSHIRO256_HPP_
+#define XOSHIRO256_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace VerifyTAPN {
+    namespace DiscreteVerification {
+        namespace Util {
+
+            /**
+             * xoshiro256++ (Blackman & Vigna), satisfies UniformRandomBitGenerator.
+             * jump() advances the state by 2^128 draws, giving non-overlapping streams for parallel runs.
+             */
+            class Xoshiro256PlusPlus {
+            public:
+                typedef uint64_t result_type;
+
+                explicit Xoshiro256PlusPlus(uint64_t value = 0) { seed(value); }
+
+                static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+
+                static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+                // The state is expanded from the seed with splitmix64, as recommended by the authors.
+                void seed(uint64_t value) {
+                    for (auto &word : s) {
+                        value += 0x9e3779b97f4a7c15ULL;
+                        uint64_t z = value;
+                        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                        word = z ^ (z >> 31);
+                    }
+                }
+
+                inline result_type operator()() {
+                    const uint64_t result = rotl(s[0] + s[3], 23) + s[0];
+                    const uint64_t t = s[1] << 17;
+                    s[2] ^= s[0];
+                    s[3] ^= s[1];
+                    s[1] ^= s[2];
+                    s[0] ^= s[3];
+                    s[2] ^= t;
+                    s[3] = rotl(s[3], 45);
+                    return result;
+                }
+
+                void jump() {
+                    static const uint64_t JUMP[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                                    0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+                    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+                    for (uint64_t jump : JUMP) {
+                        for (int b = 0; b < 64; b++) {
+                            if (jump & (uint64_t(1) << b)) {
+                                s0 ^= s[0];
+                                s1 ^= s[1];
+                                s2 ^= s[2];
+                                s3 ^= s[3];
+                            }
+                            (*this)();
+                        }
+                    }
+                    s[0] = s0;
+                    s[1] = s1;
+                    s[2] = s2;
+                    s[3] = s3;
+                }
+
+                inline uint64_t stateWord(int i) const { return s[i]; }
+
+            private:
+                static inline uint64_t rotl(const uint64_t x, int k) {
+                    return (x << k) | (x >> (64 - k));
+                }
+
+                uint64_t s[4];
+            };
+
+            /**
+             * Independent xoshiro256++ generators, one per lane, with the state words stored as a structure of arrays
+             * so that drawing a number for every lane is a single loop the compiler can vectorise.
+             */
+            class Xoshiro256PlusPlusLanes {
+            public:
+                explicit Xoshiro256PlusPlusLanes(size_t lanes = 0) { resize(lanes); }
+
+                void resize(size_t lanes) {
+                    for (auto &word : s) word.assign(lanes, 0);
+                }
+
+                inline size_t lanes() const { return s[0].size(); }
+
+                // Lane l draws the stream of a Xoshiro256PlusPlus seeded with value and jumped first + l times.
+                void seed(uint64_t value, uint64_t first) {
+                    Xoshiro256PlusPlus engine(value);
+                    for (uint64_t i = 0; i < first; i++) engine.jump();
+                    for (size_t l = 0; l < lanes(); l++) {
+                        for (int w = 0; w < 4; w++) s[w][l] = engine.stateWord(w);
+                        engine.jump();
+                    }
+                }
+
+                // Writes the next number of every lane l to out[l].
+                void operator()(uint64_t *out) {
+                    uint64_t *s0 = s[0].data(), *s1 = s[1].data(), *s2 = s[2].data(), *s3 = s[3].data();
+                    const size_t n = lanes();
+                    for (size_t l = 0; l < n; l++) {
+                        const uint64_t result = rotl(s0[l] + s3[l], 23) + s0[l];
+                        const uint64_t t = s1[l] << 17;
+                        s2[l] ^= s0[l];
+                        s3[l] ^= s1[l];
+                        s1[l] ^= s2[l];
+                        s0[l] ^= s3[l];
+                        s2[l] ^= t;
+                        s3[l] = rotl(s3[l], 45);
+                        out[l] = result;
+                    }
+                }
+
+            private:
+                static inline uint64_t rotl(const uint64_t x, int k) {
+                    return (x << k) | (x >> (64 - k));
+                }
+
+                std::vector<uint64_t> s[4];
+            };
+
+        }
+    }
+}
+
+#endif /* XOSHIRO256_HPP_ */
@@ -25,6 +25,7 @@
 #include "DiscreteVerification/DataStructures/WaitingList.hpp"
 
 #include <memory>
+#include <type_traits>
 
 namespace VerifyTAPN { namespace DiscreteVerification {
    
@@ -68,6 +69,14 @@ namespace VerifyTAPN { namespace DiscreteVerification {
     protected:
         SRes generateAndInsertSuccessors(NonStrictMarkingBase &from);
 
+        // Generators that depend on the options take them as a third constructor argument
+        static S makeGenerator(TAPN::TimedArcPetriNet &tapn, AST::Query *query, const VerificationOptions &options) {
+            if constexpr (std::is_constructible_v<S, TAPN::TimedArcPetriNet &, AST::Query *, const VerificationOptions &>)
+                return S(tapn, query, options);
+            else
+                return S(tapn, query);
+        }
+
         S successorGenerator;
         U *lastMarking;
         U *tmpParent;
@@ -78,7 +87,8 @@ namespace VerifyTAPN { namespace DiscreteVerification {
     AbstractNaiveVerification<T, U, S>::AbstractNaiveVerification(TAPN::TimedArcPetriNet &tapn, U &initialMarking,
                                                                   AST::Query *query, const VerificationOptions &options,
                                                                   T *pwList)
-            : Verification<U>(tapn, initialMarking, query, options), successorGenerator(tapn, query),
+            : Verification<U>(tapn, initialMarking, query, options),
+              successorGenerator(makeGenerator(tapn, query, options)),
               lastMarking(nullptr), pwList(pwList) {
 
     }
@@ -88,6 +98,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         std::cout << "  discovered markings:\t" << pwList->discoveredMarkings << std::endl;
         std::cout << "  explored markings:\t" << pwList->size() - pwList->explored() << std::endl;
         std::cout << "  stored markings:\t" << pwList->size() << std::endl;
+        successorGenerator.printReductionStatistics(std::cout);
     }
 
     template<typename T, typename U, typename S>
@@ -0,0 +1,72 @@
+/*
+ * ParallelTimeDartReachabilitySearch.hpp
+ *
+ * Time dart reachability search expanding darts on several threads.
+ */
+
+#ifndef PARALLELTIMEDARTREACHABILITYSEARCH_HPP_
+#define PARALLELTIMEDARTREACHABILITYSEARCH_HPP_
+
+#include "TimeDartVerification.hpp"
+#include "DiscreteVerification/DataStructures/ConcurrentTimeDartStore.hpp"
+#include "DiscreteVerification/DataStructures/WorkStealingQueue.hpp"
+#include "Core/Query/AST.hpp"
+#include "Core/VerificationOptions.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace VerifyTAPN { namespace DiscreteVerification {
+
+    /**
+     * Workers pop darts from a shared work-stealing frontier, claim the not yet passed part of the dart and insert
+     * the successors in a concurrent dart store, see ConcurrentTimeDartStore. Each worker has its own successor
+     * generator and place statistics, merged when the search ends. The query visitor writes into the AST (also in
+     * the parts shared by copies of a query), so new markings are checked one at a time. The exploration order is
+     * decided by the frontier, so the search strategy is ignored, and no trace is produced. Partial order reduction
+     * is not applied, the stubborn sets evaluate the query as well.
+     */
+    class ParallelTimeDartReachabilitySearch : public TimeDartVerification {
+    public:
+        ParallelTimeDartReachabilitySearch(TAPN::TimedArcPetriNet &tapn, NonStrictMarkingBase &initialMarking,
+                                           AST::Query *query, const VerificationOptions &options);
+
+        ~ParallelTimeDartReachabilitySearch() override = default;
+
+        bool run() override;
+
+        void printStats() override;
+
+        inline unsigned int maxUsedTokens() override { return maxNumTokensInAnyMarking; };
+
+    protected:
+        struct Worker {
+            Worker(const TAPN::TimedArcPetriNet &tapn, AST::Query *query, size_t places)
+                    : generator(tapn, query), placeStats(places) {}
+
+            Generator generator;
+            std::vector<int> placeStats;
+            long long explored = 0;
+            long long discovered = 0;
+            int maxNumTokens = -1;
+        };
+
+        void work(size_t id, Worker &worker);
+
+        void expand(size_t id, Worker &worker, ConcurrentTimeDart &dart, int from, int to);
+
+        // Adds a successor to the store and checks the query on it if new; true if the query is satisfied.
+        bool handleSuccessor(size_t id, Worker &worker, NonStrictMarkingBase *marking);
+
+        size_t nthreads;
+        std::unique_ptr<ConcurrentTimeDartStore> store;
+        std::unique_ptr<WorkStealingQueue<ConcurrentTimeDart *>> frontier;
+        std::mutex queryLock;
+        std::atomic<bool> found{false};
+        long long discoveredMarkings = 0;
+        int maxNumTokensInAnyMarking = -1;
+    };
+
+} } /* namespace VerifyTAPN */
+#endif /* PARALLELTIMEDARTREACHABILITYSEARCH_HPP_ */
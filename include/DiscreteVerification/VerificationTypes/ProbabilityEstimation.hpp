@@ -2,6 +2,7 @@
 #define PROBABILITYESTIMATION_HPP
 
 #include "DiscreteVerification/VerificationTypes/SMCVerification.hpp"
+#include "DiscreteVerification/Util/RunStatistics.hpp"
 
 namespace VerifyTAPN::DiscreteVerification {
 
@@ -17,11 +18,13 @@ class ProbabilityEstimation : public SMCVerification {
             TAPN::TimedArcPetriNet &tapn, RealMarking &initialMarking, AST::SMCQuery *query, VerificationOptions options, unsigned int runs
         )
         : SMCVerification(tapn, initialMarking, query, options), validRuns(0), runsNeeded(runs)
+        , estimationMethod(VerificationOptions::FIXED_ESTIMATION)
         { }
 
         bool handleSuccessor(RealMarking* marking) override;
         void handleRunResult(const bool res, int steps, double delay) override;
         bool mustDoAnotherRun() override;
+        bool supportsBatchRuns() const override { return options.getSmcTraces() == 0; }
 
         void prepare() override;
 
@@ -29,13 +32,17 @@ class ProbabilityEstimation : public SMCVerification {
 
         void computeChernoffHoeffdingBound(const float intervalWidth, const float confidence);
 
+        // Sequential stopping rule: true once the interval at the requested confidence lies within
+        // estimationIntervalWidth of the estimation. runsNeeded stays the upper bound on the number of runs.
+        bool estimationIntervalReached();
+
         void printStats() override;
 
         void printValidRunsStats();
         void printViolatingRunsStats();
         void printGlobalRunsStats();
 
-        static void printRunsStats(const std::string category, unsigned long n, unsigned long totalSteps, double totalDelay, std::vector<int> perStep, std::vector<float> perDelay);
+        static void printRunsStats(const std::string category, const Util::RunningStatistics& steps, const Util::RunningStatistics& delays);
 
         void printCumulativeStats();
 
@@ -45,17 +52,21 @@ class ProbabilityEstimation : public SMCVerification {
 
         unsigned int runsNeeded;
         unsigned int validRuns;
-        double validRunsTime = 0;
-        unsigned long validRunsSteps = 0;
-        double violatingRunTime = 0;
-        unsigned long violatingRunSteps = 0;
-
-        std::vector<int> validPerStep;
-        std::vector<float> validPerDelay;
-        std::vector<int> violatingPerStep;
-        std::vector<float> violatingPerDelay;
+
+        // Statistics are accumulated as the runs come, so the memory does not grow with the number of runs
+        Util::RunningStatistics validSteps, validDelays;
+        Util::RunningStatistics violatingSteps, violatingDelays;
+        Util::RunningStatistics runSteps, runDelays;
+        std::vector<int> validPerStep; // bounded by the length of the longest valid run
+        Util::StreamingHistogram validPerDelay;
         float maxValidDuration = 0.0f;
 
+        VerificationOptions::SMCEstimationMethod estimationMethod;
+        double normalQuantile = 0;
+        size_t nextIntervalCheck = 0;
+        bool intervalReached = false;
+        double reachedWidth = 0; // half-width of the interval that stopped the runs, if intervalReached
+
 };
 
 }
@@ -13,6 +13,9 @@ class ProbabilityFloatComparison : public SMCVerification {
             TAPN::TimedArcPetriNet &tapn, RealMarking &initialMarking, AST::SMCQuery *query, VerificationOptions options
         );
 
+        // Runs are fed to the test in the order they were started rather than finished, as sequentially.
+        bool parallel_run() override;
+
         bool handleSuccessor(RealMarking* marking) override;
         void handleRunResult(const bool res, int steps, double delay) override;
         bool mustDoAnotherRun() override;
@@ -35,6 +38,8 @@ class ProbabilityFloatComparison : public SMCVerification {
         float boundH1;
         bool result;
         unsigned int validRuns;
+        size_t simulatedRuns = 0;
+        int64_t decisionNs = 0;
 
 };
 
@@ -0,0 +1,51 @@
+#ifndef PROBABILITYSPLITTING_HPP
+#define PROBABILITYSPLITTING_HPP
+
+#include "DiscreteVerification/VerificationTypes/SMCVerification.hpp"
+
+namespace VerifyTAPN::DiscreteVerification {
+
+/**
+ * Rare event estimation by fixed-effort multilevel splitting. The levels are the values of the distance from a
+ * marking to the query (see DistanceQueryVisitor): from the states entering level d, getSmcSplitting() runs are
+ * continued until they enter level d - 1 or end, and the probability is the product of the fractions of runs entering
+ * each level. Independent replications of the whole estimation give the confidence interval.
+ */
+class ProbabilitySplitting : public SMCVerification {
+
+    public:
+
+        ProbabilitySplitting(
+            TAPN::TimedArcPetriNet &tapn, RealMarking &initialMarking, AST::SMCQuery *query, VerificationOptions options
+        )
+        : SMCVerification(tapn, initialMarking, query, options)
+        { }
+
+        bool run() override;
+        bool parallel_run() override;
+
+        bool handleSuccessor(RealMarking* marking) override;
+        void handleRunResult(const bool res, int steps, double delay) override;
+        bool mustDoAnotherRun() override;
+
+        void prepare() override;
+
+        // Estimation of the probability that a run satisfies the query, by one replication on generator.
+        double splittingEstimate(SMCRunGenerator& generator);
+
+        float getEstimation();
+
+        void printResult() override;
+
+    protected:
+
+        int distance(RealMarking* marking);
+        void addEstimate(double estimate, size_t runs, unsigned long steps, double time);
+
+        std::vector<double> estimates;
+
+};
+
+}
+
+#endif /*PROBABILITYSPLITTING_HPP*/
@@ -4,6 +4,7 @@
 #include "DiscreteVerification/VerificationTypes/Verification.hpp"
 #include "DiscreteVerification/DataStructures/NonStrictMarking.hpp"
 #include "DiscreteVerification/Generators/SMCRunGenerator.h"
+#include "DiscreteVerification/Generators/SMCBatchRunGenerator.h"
 #include "Core/Query/SMCQuery.hpp"
 
 #include <mutex>
@@ -23,6 +24,10 @@ class SMCVerification : public Verification<RealMarking> {
 
         virtual bool run() override;
         virtual bool parallel_run();
+        // Simulates the runs in lockstep batches of getSmcBatch() runs, on several threads if parallel.
+        virtual bool batch_run();
+        // The batch generator only reports the result, length and duration of each run.
+        virtual bool supportsBatchRuns() const { return false; }
 
         virtual void prepare() { }
 
@@ -47,18 +52,16 @@ class SMCVerification : public Verification<RealMarking> {
 
         void getTrace() override;
 
-        void printHumanTrace(std::stack<RealMarking *> &stack, const std::string& name);
+        void printHumanTrace(const SMCTrace& trace, const std::string& name);
 
-        void printXMLTrace(std::stack<RealMarking *> &stack, const std::string& name, rapidxml::xml_document<> &doc, rapidxml::xml_node<>* list_node);
+        void printXMLTrace(const SMCTrace& trace, const std::string& name, Util::XMLTraceWriter &writer);
 
-        rapidxml::xml_node<> *createTransitionNode(RealMarking *old, RealMarking *current, rapidxml::xml_document<> &doc);
+        void printTransition(Util::XMLTraceWriter &writer, RealMarking *old, RealMarking *current);
 
-        void createTransitionSubNodes(RealMarking *old, RealMarking *current, rapidxml::xml_document<> &doc,
-                                      rapidxml::xml_node<> *transitionNode, const TAPN::TimedPlace &place,
-                                      const TAPN::TimeInterval &interval, int weight);
+        void printTransitionTokens(Util::XMLTraceWriter &writer, RealMarking *old, RealMarking *current,
+                                   const TAPN::TimedPlace &place, const TAPN::TimeInterval &interval, int weight);
 
-        rapidxml::xml_node<> *
-        createTokenNode(rapidxml::xml_document<> &doc, const TAPN::TimedPlace &place, const RealToken &token);
+        void printToken(Util::XMLTraceWriter &writer, const TAPN::TimedPlace &place, double age);
 
     protected:
 
@@ -72,7 +75,7 @@ class SMCVerification : public Verification<RealMarking> {
 
         std::mutex run_res_mutex;
 
-        std::vector<std::stack<RealMarking*>> traces;
+        std::vector<SMCTrace> traces;
 
 };
 
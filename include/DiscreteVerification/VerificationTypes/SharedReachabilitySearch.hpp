@@ -0,0 +1,77 @@
+#ifndef SHAREDREACHABILITYSEARCH_HPP_
+#define SHAREDREACHABILITYSEARCH_HPP_
+
+#include "ReachabilitySearch.hpp"
+
+#include <vector>
+
+namespace VerifyTAPN { namespace DiscreteVerification {
+
+    /**
+     * Reachability search answering a set of EF/AG queries with a single exploration.
+     * Every new marking is checked against all undecided queries; a query is retired the first time its
+     * (EF) or its negated (AG) proposition holds, and the search stops once all queries are decided.
+     * B is either ReachabilitySearch<Generator> or ReachabilitySearchPTrie<Generator>; partial order
+     * reduction is query dependent and hence cannot be shared.
+     */
+    template<typename B>
+    class SharedReachabilitySearch : public B {
+    public:
+        template<typename W>
+        SharedReachabilitySearch(TAPN::TimedArcPetriNet &tapn, NonStrictMarking &initialMarking,
+                                 const std::vector<AST::Query *> &queries, const VerificationOptions &options,
+                                 WaitingList<W> *waiting_list)
+                : B(tapn, initialMarking, queries.front(), options, waiting_list), queries(queries),
+                  decided(queries.size(), false) {}
+
+        virtual ~SharedReachabilitySearch() = default;
+
+        // true if the query was decided during the exploration, i.e. EF is satisfied or AG is violated.
+        inline bool isDecided(size_t i) const { return decided[i]; }
+
+        inline size_t numberOfDecided() const { return numDecided; }
+
+    protected:
+        bool handleSuccessor(NonStrictMarking *marking, NonStrictMarking *parent) override {
+            marking->cut(this->placeStats);
+            marking->setParent(parent);
+
+            unsigned int size = marking->size();
+
+            this->pwList->setMaxNumTokensIfGreater(size);
+
+            if (size > this->options.getKBound()) {
+                delete marking;
+                return false;
+            }
+
+            if (this->pwList->add(marking)) {
+                for (size_t i = 0; i < queries.size(); ++i) {
+                    if (decided[i]) continue;
+                    QueryVisitor<NonStrictMarking> checker(*marking, this->tapn);
+                    AST::BoolResult context;
+                    queries[i]->accept(checker, context);
+                    if (context.value) {
+                        decided[i] = true;
+                        ++numDecided;
+                    }
+                }
+                if (numDecided == queries.size()) {
+                    this->lastMarking = marking;
+                    return true;
+                }
+                this->deleteMarking(marking);
+            } else {
+                delete marking;
+            }
+            return false;
+        }
+
+    private:
+        std::vector<AST::Query *> queries;
+        std::vector<bool> decided;
+        size_t numDecided = 0;
+    };
+
+} } /* namespace VerifyTAPN */
+#endif /* SHAREDREACHABILITYSEARCH_HPP_ */
@@ -0,0 +1,54 @@
+#ifndef STATESPACECACHESEARCH_HPP_
+#define STATESPACECACHESEARCH_HPP_
+
+#include "ReachabilitySearch.hpp"
+#include "DiscreteVerification/DataStructures/StateSpaceCache.hpp"
+
+namespace VerifyTAPN { namespace DiscreteVerification {
+
+    /**
+     * Explores the complete discrete state-space (up to the k-bound) and writes every stored marking to a
+     * StateSpaceCache. The query is only used to guide the waiting list; run() never terminates early.
+     */
+    class StateSpaceCacheSearch : public ReachabilitySearch<Generator> {
+    public:
+        StateSpaceCacheSearch(TAPN::TimedArcPetriNet &tapn, NonStrictMarking &initialMarking, AST::Query *query,
+                              const VerificationOptions &options, WaitingList<NonStrictMarking *> *waiting_list,
+                              StateSpaceCache &cache)
+                : ReachabilitySearch<Generator>(tapn, initialMarking, query, options, waiting_list), cache(cache) {}
+
+        bool run() override {
+            cache.beginWrite();
+            ReachabilitySearch<Generator>::run();
+            cache.endWrite(maxUsedTokens());
+            return false;
+        }
+
+    protected:
+        bool handleSuccessor(NonStrictMarking *marking, NonStrictMarking *parent) override {
+            marking->cut(this->placeStats);
+            marking->setParent(parent);
+
+            unsigned int size = marking->size();
+
+            this->pwList->setMaxNumTokensIfGreater(size);
+
+            if (size > this->options.getKBound()) {
+                delete marking;
+                return false;
+            }
+
+            if (this->pwList->add(marking)) {
+                cache.write(*marking);
+            } else {
+                delete marking;
+            }
+            return false;
+        }
+
+    private:
+        StateSpaceCache &cache;
+    };
+
+} } /* namespace VerifyTAPN */
+#endif /* STATESPACECACHESEARCH_HPP_ */
@@ -14,6 +14,7 @@
 #include "Core/Query/AST.hpp"
 #include "Core/VerificationOptions.hpp"
 #include "DiscreteVerification/QueryVisitor.hpp"
+#include "DiscreteVerification/DeadlockVisitor.hpp"
 #include "DiscreteVerification/DataStructures/NonStrictMarkingBase.hpp"
 #include "TimeDartVerification.hpp"
 #include "DiscreteVerification/DataStructures/TimeDart.hpp"
@@ -30,12 +31,14 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         TimeDartLiveness(TAPN::TimedArcPetriNet &tapn, NonStrictMarkingBase &initialMarking, AST::Query *query,
                          VerificationOptions options)
                 : TimeDartVerification(tapn, std::move(options), query, initialMarking) {
+            deadlockQuery = containsDeadlock(query);
         };
 
         TimeDartLiveness(TAPN::TimedArcPetriNet &tapn, NonStrictMarkingBase &initialMarking, AST::Query *query,
                          const VerificationOptions &options, WaitingList<WaitingDart *> *waiting_list)
                 : TimeDartVerification(tapn, options, query, initialMarking) {
             pwList = new TimeDartLivenessPWHashMap(options, waiting_list);
+            deadlockQuery = containsDeadlock(query);
         };
 
         virtual ~TimeDartLiveness();
@@ -57,8 +60,20 @@ namespace VerifyTAPN { namespace DiscreteVerification {
 
         bool canDelayForever(NonStrictMarkingBase *marking);
 
+        /**
+         * Computes the delays [lo, hi] of the dart of marking (in base form) in which the query holds, false if
+         * there are none. Without the deadlock proposition the query only depends on the token counts and holds in
+         * all or none of them. With it, the delays ending in a deadlock are the ones from the first such delay on
+         * (a deadlock either has no delay left, or all tokens above the max constants and stays one), found with a
+         * binary search; the query is then evaluated once before and once from that delay.
+         */
+        bool queryWindow(NonStrictMarkingBase *marking, int &lo, int &hi);
+
+        static bool containsDeadlock(AST::Query *query);
+
     protected:
         int validChildren{};
+        bool deadlockQuery = false;
         TimeDartLivenessPWBase *pwList{};
 
         virtual inline void deleteBase(NonStrictMarkingBase *base) {
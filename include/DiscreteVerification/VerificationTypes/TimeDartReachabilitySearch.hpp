@@ -24,8 +24,6 @@
 
 namespace VerifyTAPN { namespace DiscreteVerification {
 
-    using namespace rapidxml;
-
     class TimeDartReachabilitySearch : public TimeDartVerification {
     public:
         TimeDartReachabilitySearch(TAPN::TimedArcPetriNet &tapn, NonStrictMarkingBase &initialMarking,
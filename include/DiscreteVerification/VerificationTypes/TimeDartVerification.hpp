@@ -8,12 +8,11 @@
 #include "DiscreteVerification/DataStructures/TimeDart.hpp"
 #include "DiscreteVerification/Generators/Generator.h"
 #include "DiscreteVerification/Generators/ReducingGenerator.hpp"
+#include <memory>
 #include <stack>
 
 namespace VerifyTAPN { namespace DiscreteVerification {
 
-    using namespace rapidxml;
-
     typedef std::pair<NonStrictMarkingBase *, int> TraceList;
 
     class TimeDartVerification : public Verification<NonStrictMarkingBase> {
@@ -26,8 +25,29 @@ namespace VerifyTAPN { namespace DiscreteVerification {
 
         int calculateStop(const TAPN::TimedTransition &transition, NonStrictMarkingBase *marking);
 
+        // 0 if an urgent transition is enabled in marking
         int maxPossibleDelay(NonStrictMarkingBase *marking);
 
+        /**
+         * Urgent transitions only have untimed input and transport arcs and their transport arcs have no invariant
+         * at the destination, so whether one is enabled only depends on the token counts, and a marking enabling one
+         * cannot delay at all. Such markings are not put in base form: they are stored as they are, as darts reached
+         * at delay 0 whose delay window is just 0, since the same marking reached at another delay is another state.
+         */
+        bool urgentEnabled(const NonStrictMarkingBase &marking) const;
+
+        /**
+         * Partial order reduction. The only delay of a dart that can be a zero time state is its last one, where a
+         * token reaches an invariant or (in darts stored exactly) an urgent transition is enabled. If that delay is
+         * among [from, to], the stubborn set of the marking there is computed and the delay is returned; transitions
+         * outside the set then only fire at the earlier delays. Returns -1 if nothing is reduced.
+         */
+        int reduceAtZeroTime(NonStrictMarkingBase *base, int from, int to);
+
+        inline bool isStubborn(const TAPN::TimedTransition &transition) const {
+            return stubborn[transition.getIndex()];
+        }
+
         void printTransitionStatistics() const {
             successorGenerator.printTransitionStatistics(std::cout);
         }
@@ -44,8 +64,27 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         }
 
     protected:
+        // An input or transport arc as used by calculateStart, transport guards are cut by the destination invariant
+        struct StartArc {
+            uint32_t place;
+            uint32_t weight;
+            int lower;
+            int upper;
+            int range;          // largest age difference of the tokens used, -1 if the guard is empty
+            bool unbounded;     // input arc without upper bound, the transition stays enabled once it is
+        };
+
+        struct StartArcs {
+            std::vector<StartArc> arcs;
+            std::vector<std::pair<uint32_t, uint32_t>> inhibitors; // place and weight
+        };
+
         int exploredMarkings;
         std::vector<const TAPN::TimedTransition *> allwaysEnabled{};
+        std::vector<const TAPN::TimedTransition *> urgentTransitions{};
+        std::vector<StartArcs> startArcs;   // by transition index
+        std::unique_ptr<StubbornSet> stubbornSet;
+        std::vector<bool> stubborn;         // by transition index, set by reduceAtZeroTime
         bool loop;
         bool deadlock;
         WaitingDart *lastMarking{};
@@ -9,39 +9,8 @@
 #include <stack>
 #include <iostream>
 
-#include <rapidxml.hpp>
-/* Adding declarations to make it compatible with gcc 4.7 and greater */
-namespace rapidxml { namespace internal {
-    template<class OutIt, class Ch>
-    inline OutIt print_children(OutIt out, const xml_node <Ch> *node, int flags, int indent);
+#include "DiscreteVerification/Util/XMLTraceWriter.hpp"
 
-    template<class OutIt, class Ch>
-    inline OutIt print_attributes(OutIt out, const xml_node <Ch> *node, int flags);
-
-    template<class OutIt, class Ch>
-    inline OutIt print_data_node(OutIt out, const xml_node <Ch> *node, int flags, int indent);
-
-    template<class OutIt, class Ch>
-    inline OutIt print_cdata_node(OutIt out, const xml_node <Ch> *node, int flags, int indent);
-
-    template<class OutIt, class Ch>
-    inline OutIt print_element_node(OutIt out, const xml_node <Ch> *node, int flags, int indent);
-
-    template<class OutIt, class Ch>
-    inline OutIt print_declaration_node(OutIt out, const xml_node <Ch> *node, int flags, int indent);
-
-    template<class OutIt, class Ch>
-    inline OutIt print_comment_node(OutIt out, const xml_node <Ch> *node, int flags, int indent);
-
-    template<class OutIt, class Ch>
-    inline OutIt print_doctype_node(OutIt out, const xml_node <Ch> *node, int flags, int indent);
-
-    template<class OutIt, class Ch>
-    inline OutIt print_pi_node(OutIt out, const xml_node <Ch> *node, int flags, int indent);
-} }
-
-#include <rapidxml_print.hpp>
-#include <utility>
 #include <utility>
 
 namespace VerifyTAPN { namespace DiscreteVerification {
@@ -70,20 +39,16 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             std::cout << "Error generating trace" << std::endl;
         }
 
-        void removeLastIfDelay(rapidxml::xml_node<> &);
-
         void printHumanTrace(T *m, std::stack<T *> &stack, AST::Quantifier query);
 
         void printXMLTrace(T *m, std::stack<T *> &stack, AST::Query *query, TAPN::TimedArcPetriNet &tapn);
 
-        rapidxml::xml_node<> *createTransitionNode(T *old, T *current, rapidxml::xml_document<> &doc);
+        void printTransition(Util::XMLTraceWriter &writer, T *old, T *current);
 
-        void createTransitionSubNodes(T *old, T *current, rapidxml::xml_document<> &doc,
-                                      rapidxml::xml_node<> *transitionNode, const TAPN::TimedPlace &place,
-                                      const TAPN::TimeInterval &interval, int weight);
+        void printTransitionTokens(Util::XMLTraceWriter &writer, T *old, T *current, const TAPN::TimedPlace &place,
+                                   const TAPN::TimeInterval &interval, int weight);
 
-        rapidxml::xml_node<> *
-        createTokenNode(rapidxml::xml_document<> &doc, const TAPN::TimedPlace &place, const Token &token);
+        void printToken(Util::XMLTraceWriter &writer, const TAPN::TimedPlace &place, const Token &token);
 
         void generateTraceStack(T *m, std::stack<T *> *result, std::stack<T *> *liveness = nullptr);
 
@@ -199,40 +164,25 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         }
     }
 
-    template<typename T>
-    void Verification<T>::removeLastIfDelay(rapidxml::xml_node<> &root) {
-        using namespace rapidxml;
-        if (root.first_node()) { // if there is a node in the trace
-            xml_node<> *node = root.last_node();
-            if (node) {
-                char *name = node->name();
-                if (strcmp(name, "delay") == 0) {
-                    root.remove_last_node();
-                }
-            }
-        }
-    }
-
     template<typename T>
     void
     Verification<T>::printXMLTrace(T *m, std::stack<T *> &stack, AST::Query *query, TAPN::TimedArcPetriNet &tapn) {
-        using namespace rapidxml;
         std::cerr << "Trace: " << std::endl;
         bool isFirst = true;
         bool foundLoop = false;
         bool delayedForever = false;
         T *old = nullptr;
 
-        xml_document<> doc;
-        xml_node<> *root = doc.allocate_node(node_element, "trace");
-        doc.append_node(root);
+        // Elements are written as the stack is unwound; delays are held back as they may have to be removed
+        Util::XMLTraceWriter writer(std::cerr);
+        writer.startElement("trace");
 
         while (!stack.empty()) {
             if (isFirst) {
                 isFirst = false;
             } else {
                 if (stack.top()->getGeneratedBy()) {
-                    root->append_node(createTransitionNode(old, stack.top(), doc));
+                    printTransition(writer, old, stack.top());
                 } else {
                     int i = 1;
                     old = stack.top();
@@ -245,11 +195,8 @@ namespace VerifyTAPN { namespace DiscreteVerification {
 
                             foundLoop = true;
                             delayloop = true;
-                            auto str = std::to_string(i * tapn.getGCD());
-                            xml_node<> *node = doc.allocate_node(node_element, "delay", doc.allocate_string(
-                                    str.c_str()));
-                            root->append_node(node);
-                            root->append_node(doc.allocate_node(node_element, "loop"));
+                            writer.element("delay", std::to_string(i * tapn.getGCD()));
+                            writer.element("loop");
 
                         }
                         if (delayloop)
@@ -263,9 +210,8 @@ namespace VerifyTAPN { namespace DiscreteVerification {
                         continue;
                     if ((!foundLoop) && stack.empty() && old->getNumberOfChildren() > 0) {
                         // remove delay before delay forever
-                        removeLastIfDelay(*root);
-                        xml_node<> *node = doc.allocate_node(node_element, "delay", doc.allocate_string("forever"));
-                        root->append_node(node);
+                        writer.discardPending();
+                        writer.element("delay", "forever");
                         delayedForever = true;
                         break;
                     }
@@ -297,10 +243,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
                         }
                     }
                     if (i > 0) {
-                        auto str = std::to_string(i * tapn.getGCD());
-                        xml_node<> *node = doc.allocate_node(node_element, "delay", doc.allocate_string(
-                                str.c_str()));
-                        root->append_node(node);
+                        writer.pendingElement("delay", std::to_string(i * tapn.getGCD()));
                     }
                     stack.push(old);
                 }
@@ -322,7 +265,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
                     temp = (T *) temp->getParent();
                 } while (temp && temp->getParent());
                 if (foundLoop) {
-                    root->append_node(doc.allocate_node(node_element, "loop"));
+                    writer.element("loop");
                 }
 
             }
@@ -333,51 +276,43 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         //Trace ended, goto * or deadlock
         if (query->getQuantifier() == AST::EG || query->getQuantifier() == AST::AF) {
             if (!foundLoop && !delayedForever) {
-                xml_node<> *node;
                 if (m->canDeadlock(tapn, 0, false)) {
                     // check if deadlock
-                    node = doc.allocate_node(node_element, "deadlock");
+                    writer.element("deadlock");
                 } else {
                     // if not it is delay forever
 
                     // remove delay before delay forever
-                    removeLastIfDelay(*root);
-                    node = doc.allocate_node(node_element, "delay", doc.allocate_string("forever"));
-
+                    writer.discardPending();
+                    writer.element("delay", "forever");
                 }
-                root->append_node(node);
             }
         }
-        std::cerr << doc;
+        writer.endDocument();
     }
 
     template<typename T>
-    rapidxml::xml_node<> *Verification<T>::createTransitionNode(T *old, T *current, rapidxml::xml_document<> &doc) {
-        using namespace rapidxml;
-        xml_node<> *transitionNode = doc.allocate_node(node_element, "transition");
-        xml_attribute<> *id = doc.allocate_attribute("id", current->getGeneratedBy()->getId().c_str());
-        transitionNode->append_attribute(id);
+    void Verification<T>::printTransition(Util::XMLTraceWriter &writer, T *old, T *current) {
+        writer.startElement("transition");
+        writer.attribute("id", current->getGeneratedBy()->getId());
 
         for (auto* arc : current->getGeneratedBy()->getPreset()) {
-            createTransitionSubNodes(old, current, doc, transitionNode, arc->getInputPlace(),
-                                     arc->getInterval(), arc->getWeight());
+            printTransitionTokens(writer, old, current, arc->getInputPlace(), arc->getInterval(), arc->getWeight());
         }
 
         for (auto* arc : current->getGeneratedBy()->getTransportArcs()) {
-            createTransitionSubNodes(old, current, doc, transitionNode, arc->getSource(),
-                                     arc->getInterval(), arc->getWeight());
+            printTransitionTokens(writer, old, current, arc->getSource(), arc->getInterval(), arc->getWeight());
         }
 
-        return transitionNode;
+        writer.endElement();
     }
 
     template<typename T>
-    void Verification<T>::createTransitionSubNodes(T *old, T *current, rapidxml::xml_document<> &doc,
-                                                   rapidxml::xml_node<> *transitionNode,
-                                                   const TAPN::TimedPlace &place,
-                                                   const TAPN::TimeInterval &interval, const int weight) {
-        TokenList current_tokens = current->getTokenList(place.getIndex());
-        TokenList old_tokens = old->getTokenList(place.getIndex());
+    void Verification<T>::printTransitionTokens(Util::XMLTraceWriter &writer, T *old, T *current,
+                                                const TAPN::TimedPlace &place,
+                                                const TAPN::TimeInterval &interval, const int weight) {
+        const TokenList& current_tokens = current->getTokenList(place.getIndex());
+        const TokenList& old_tokens = old->getTokenList(place.getIndex());
         int tokensFound = 0;
 
         TokenList::const_iterator n_iter = current_tokens.begin();
@@ -385,14 +320,14 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         while (n_iter != current_tokens.end() && o_iter != old_tokens.end()) {
             if (n_iter->getAge() == o_iter->getAge()) {
                 for (int i = 0; i < o_iter->getCount() - n_iter->getCount(); i++) {
-                    transitionNode->append_node(createTokenNode(doc, place, *n_iter));
+                    printToken(writer, place, *n_iter);
                     tokensFound++;
                 }
                 n_iter++;
                 o_iter++;
             } else {
                 if (n_iter->getAge() > o_iter->getAge()) {
-                    transitionNode->append_node(createTokenNode(doc, place, *o_iter));
+                    printToken(writer, place, *o_iter);
                     tokensFound++;
                     o_iter++;
                 } else {
@@ -403,7 +338,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
 
         for (TokenList::const_iterator iter = n_iter; iter != current_tokens.end(); iter++) {
             for (int i = 0; i < iter->getCount(); i++) {
-                transitionNode->append_node(createTokenNode(doc, place, *iter));
+                printToken(writer, place, *iter);
                 tokensFound++;
             }
         }
@@ -412,7 +347,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             if(tokensFound >= weight) break;
             if (token.getAge() >= interval.getLowerBound()) {
                 for (int i = 0; i < token.getCount() && tokensFound < weight; i++) {
-                    transitionNode->append_node(createTokenNode(doc, place, token));
+                    printToken(writer, place, token);
                     tokensFound++;
                 }
             }
@@ -420,29 +355,12 @@ namespace VerifyTAPN { namespace DiscreteVerification {
     }
 
     template<typename T>
-    rapidxml::xml_node<> *
-    Verification<T>::createTokenNode(rapidxml::xml_document<> &doc, const TAPN::TimedPlace &place,
-                                     const Token &token) {
-        using namespace rapidxml;
-        xml_node<> *tokenNode = doc.allocate_node(node_element, "token");
-        xml_attribute<> *placeAttribute = doc.allocate_attribute("place",
-                                                                 doc.allocate_string(place.getName().c_str()));
-        tokenNode->append_attribute(placeAttribute);
-        auto str = std::to_string(token.getAge() * tapn.getGCD());
-        xml_attribute<> *ageAttribute = doc.allocate_attribute("age", doc.allocate_string(
-                str.c_str()));
-        tokenNode->append_attribute(ageAttribute);
-        if (place.getMaxConstant() < token.getAge()) {
-            xml_attribute<> *gtAttribute = doc.allocate_attribute("greaterThanOrEqual",
-                                                                  doc.allocate_string("true"));
-            tokenNode->append_attribute(gtAttribute);
-        } else {
-            xml_attribute<> *gtAttribute = doc.allocate_attribute("greaterThanOrEqual",
-                                                                  doc.allocate_string("false"));
-            tokenNode->append_attribute(gtAttribute);
-        }
-
-        return tokenNode;
+    void Verification<T>::printToken(Util::XMLTraceWriter &writer, const TAPN::TimedPlace &place, const Token &token) {
+        writer.startElement("token");
+        writer.attribute("place", place.getName());
+        writer.attribute("age", std::to_string(token.getAge() * tapn.getGCD()));
+        writer.attribute("greaterThanOrEqual", place.getMaxConstant() < token.getAge() ? "true" : "false");
+        writer.endElement();
     }
 
     template<typename T>
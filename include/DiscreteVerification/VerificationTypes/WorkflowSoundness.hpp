@@ -9,6 +9,7 @@
 #define WORKFLOWSOUNDNESS_HPP_
 
 #include "DiscreteVerification/DataStructures/WorkflowPWList.hpp"
+#include "DiscreteVerification/DataStructures/ReverseEdgeStore.hpp"
 #include "Core/TAPN/TAPN.hpp"
 #include "Core/Query/AST.hpp"
 #include "Core/VerificationOptions.hpp"
@@ -70,14 +71,16 @@ namespace VerifyTAPN { namespace DiscreteVerification {
 
         ModelType calculateModelType();
 
-        virtual void addParentMeta(MetaData *meta, MetaData *parent);
+        // Number of the state of meta in reverseEdges
+        virtual uint32_t &stateId(MetaData *meta);
 
         virtual void setMetaParent(NonStrictMarking *) {};
 
     protected:
-        std::stack<MetaData *> passedStack{};
+        std::vector<MetaData *> states{};        // indexed by state number
+        std::vector<uint32_t> finalStates{};
+        ReverseEdgeStore reverseEdges;
         int minExec;
-        unsigned int linearSweepTreshold;
         NonStrictMarking *coveredMarking;
         ModelType modelType;
 
@@ -90,9 +93,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
                                const VerificationOptions &options,
                                WaitingList<ptriepointer_t<MetaData *> > *waiting_list);
 
-        void addParentMeta(MetaData *meta, MetaData *parent) override;
-
-        int numberOfPassed() override;
+        uint32_t &stateId(MetaData *meta) override;
 
         void deleteMarking(NonStrictMarking *marking) override {
             delete marking;
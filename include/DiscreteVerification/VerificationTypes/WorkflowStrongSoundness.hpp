@@ -28,6 +28,9 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         ~WorkflowStrongSoundnessReachability() {
             pwList->deleteWaitingList();
             delete lastMarking;
+            for (auto *marking : traceMarkings) {
+                delete marking;
+            }
             delete pwList;
         }
 
@@ -41,18 +44,51 @@ namespace VerifyTAPN { namespace DiscreteVerification {
 
 
     protected:
+        struct Edge {
+            uint32_t target;
+            int32_t transition;     // index of the fired transition, -1 for a delay
+        };
+
         void findInOut();
 
         bool handleSuccessor(NonStrictMarking *marking, NonStrictMarking *parent);
 
-        virtual void swapData(NonStrictMarking *marking, NonStrictMarking *old);
+        /**
+         * Decomposes the explored graph into strongly connected components (Tarjan). A delay edge inside a component
+         * is a cycle letting time diverge. Otherwise the components form a DAG, and the longest delay to every
+         * state is computed over it in topological order; maxValue is the largest one of a final marking. Returns
+         * true if the net is not strongly sound, i.e. time can diverge or a delay exceeds the workflow bound.
+         */
+        bool analyse();
+
+        // Appends a path from the initial marking to state, along which state gets its longest delay.
+        void pathTo(uint32_t state, std::vector<std::pair<uint32_t, int32_t> > &path);
+
+        // Sets lastMarking to the end of a path of copies of the stored markings, for getTrace.
+        void makeTrace(const std::vector<std::pair<uint32_t, int32_t> > &path);
+
+        // Appends a path from the state from to the state to inside their component, without from itself.
+        void pathInComponent(uint32_t from, uint32_t to, std::vector<std::pair<uint32_t, int32_t> > &path);
+
+        virtual uint32_t &stateId(MetaData *meta);
 
-        virtual void clearTrace() {};    // cleanup
+        virtual void addState(NonStrictMarking *marking);
+
+        virtual NonStrictMarking *copyOfState(uint32_t state);
 
     protected:
         int maxValue;
         TimedPlace *outPlace;
-        int validChildren{};
+        std::vector<NonStrictMarking *> markings;   // stored markings by state number
+        std::vector<bool> terminal;                 // has a token in the out place
+        std::vector<size_t> edgeBegin;              // edges of state s are [edgeBegin[s], edgeEnd[s])
+        std::vector<size_t> edgeEnd;
+        std::vector<Edge> edges;
+        std::vector<uint32_t> component;                // of each state, after analyse
+        std::vector<uint32_t> members;                  // states sorted by component
+        std::vector<uint32_t> componentBegin;           // members of component c from componentBegin[c]
+        std::vector<std::pair<uint32_t, size_t> > reachedBy;  // state and edge giving a component its delay
+        std::vector<NonStrictMarking *> traceMarkings;
     };
 
     class WorkflowStrongSoundnessPTrie : public WorkflowStrongSoundnessReachability {
@@ -64,16 +100,18 @@ namespace VerifyTAPN { namespace DiscreteVerification {
                 VerificationOptions options,
                 WaitingList <ptriepointer_t<MetaData *>> *waiting_list);
 
-        void getTrace() override;
-
         void deleteMarking(NonStrictMarking *marking) override {
             delete marking;
         }
 
     protected:
-        void swapData(NonStrictMarking *marking, NonStrictMarking *old) override;
+        uint32_t &stateId(MetaData *meta) override;
+
+        void addState(NonStrictMarking *marking) override;
+
+        NonStrictMarking *copyOfState(uint32_t state) override;
 
-        void clearTrace() override;
+        std::vector<MetaDataWithTraceAndEncoding *> metas;  // by state number, instead of markings
     };
 
 } } /* namespace VerifyTAPN */
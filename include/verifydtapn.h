@@ -14,9 +14,13 @@
 
 #include <memory>
 #include <vector>
+#include <string>
 
 using namespace VerifyTAPN;
 namespace VerifyTAPN {
+std::vector<std::pair<std::unique_ptr<AST::Query>, std::string>>
+parse_query_list(const VerificationOptions& options, const unfoldtacpn::ColoredPetriNetBuilder& builder, const TAPN::TimedArcPetriNet& net);
+
 std::unique_ptr<AST::Query> parse_queries(const VerificationOptions& options, const unfoldtacpn::ColoredPetriNetBuilder& builder, const TAPN::TimedArcPetriNet& net);
 
 std::pair<std::vector<int>,std::unique_ptr<TAPN::TimedArcPetriNet>>
@@ -26,6 +30,14 @@ std::pair<std::vector<int>,std::unique_ptr<TAPN::TimedArcPetriNet>>
 parse_net_file(unfoldtacpn::ColoredPetriNetBuilder& builder, const std::string& filename);
 
 std::unique_ptr<AST::Query> make_query(const unfoldtacpn::ColoredPetriNetBuilder& builder, VerificationOptions& options, const TAPN::TimedArcPetriNet& net);
+
+void check_query_options(const AST::Query& query, VerificationOptions& options);
+
+int verify_query(TAPN::TimedArcPetriNet& net, const std::vector<int>& initialPlacement, AST::Query* query, VerificationOptions& options);
+
+// verifies all queries selected by --xml-queries against the same (already unfolded and initialized) net
+int verify_queries(const unfoldtacpn::ColoredPetriNetBuilder& builder, const VerificationOptions& options,
+                   TAPN::TimedArcPetriNet& net, const std::vector<int>& initialPlacement);
 }
 #endif /* VERIFYDTAPN_H */
 
@@ -168,12 +168,21 @@ namespace VerifyTAPN {
             ("strong-workflow-bound", po::value<size_t>(), "Maximum delay bound for strong workflow analysis")
             ("compute-cmax", "Calculate the place bounds.")
             ("disable-partial-order", "Disable partial order reduction")
+            ("query-guided-reduction", "Enable partial order reduction, choosing the interesting transitions from the values of the query in each marking (reduces more, costs more per marking)")
+            ("shared-exploration", "Verify all EF/AG queries selected by --xml-queries using a single shared exploration")
+            ("threads", po::value<unsigned int>(), "Number of threads used by the time dart reachability search and the last phase of workflow soundness, 0 for the number of hardware threads (default = 1, traces and memory optimization need 1)")
+            ("state-space-cache", po::value<std::string>(), "Store the explored state-space of EF/AG queries in the given file and reuse it for later queries on the same model and k-bound")
             ("write-unfolded-net", po::value<std::string>(), "Outputs the model to the given file before structural reduction but after unfolding")
             ("bindings,b", "Print bindings to stderr in XML format (only for CPNs, default is not to print)")
             ("write-unfolded-queries", po::value<std::string>(), "Outputs the queries to the given file before query reduction but after unfolding")
             ("strategy-output", po::value<std::string>(), "File to write synthesized strategy to, use '_' (an underscore) for stdout")
             ("smc-benchmark", po::value<unsigned int>(), "Benchmark mode for SMC, runs the number of runs specified to estimate performance")
             ("smc-parallel", po::bool_switch()->default_value(false), "Enable parallel verification for SMC.")
+            ("smc-threads", po::value<unsigned int>(), "Number of threads used by parallel SMC (default: number of hardware threads)")
+            ("smc-batch", po::value<unsigned int>(), "Simulate SMC runs in lockstep batches of the given number of runs (probability estimation without traces only, default = 0 : disabled)")
+            ("smc-splitting", po::value<unsigned int>(), "Estimate rare event probabilities by fixed-effort importance splitting, with the given number of runs per level (default = 0 : disabled)")
+            ("smc-splitting-replications", po::value<unsigned int>(), "Number of independent splitting estimates used to compute the confidence interval (default = 10)")
+            ("seed", po::value<uint64_t>(), "Seed for the random number generators used by SMC, makes the runs of each thread reproducible")
             ("smc-print-cumulative-stats", po::value<unsigned int>(), "Prints the cumulative probability stats for SMC quantitative estimation, specifying the rounding precision")
             ("smc-steps-scale", po::value<unsigned int>(), "Specify the number of slices to use to print steps cumulative stats (scale = 0 means every step, default = 500)")
             ("smc-time-scale", po::value<unsigned int>(), "Specify the number of slices to use to print time cumulative stats (scale = 0 means every 1 unit, default = 500)")
@@ -182,6 +191,10 @@ namespace VerifyTAPN {
                   " 0: any (default)\n"
                   " 1: only runs satisfying the property\n"
                   " 2: only runs not satisfying the property")
+            ("smc-estimation-method", po::value<unsigned int>(), "Specify how the number of runs of SMC quantitative estimation is chosen.\n"
+                  " 0: fixed, from the Chernoff-Hoeffding bound (default)\n"
+                  " 1: sequential, stop when the Wilson score interval is narrow enough\n"
+                  " 2: sequential, stop when the Bayesian credible interval is narrow enough")
             ("smc-numeric-precision", po::value<unsigned int>(), "Specify the number of rounding digits to use in SMC verifications (default = 5, 0 means no rounding).");
             
     }
@@ -246,9 +259,23 @@ namespace VerifyTAPN {
         if(vm.count("calculate-cmax"))
             opts.setCalculateCmax(true);
 
+        if(vm.count("query-guided-reduction")) {
+            opts.setPartialOrderReduction(true);
+            opts.setQueryGuidedReduction(true);
+        }
+
         if(vm.count("disable-partial-order"))
             opts.setPartialOrderReduction(false);
 
+        if(vm.count("shared-exploration"))
+            opts.setSharedExploration(true);
+
+        if(vm.count("threads"))
+            opts.setThreads(vm["threads"].as<unsigned int>());
+
+        if(vm.count("state-space-cache"))
+            opts.setStateSpaceCache(vm["state-space-cache"].as<std::string>());
+
         if(vm.count("write-unfolded-net"))
             opts.setOutputModelFile(vm["write-unfolded-net"].as<std::string>());
 
@@ -272,6 +299,26 @@ namespace VerifyTAPN {
             opts.setParallel(vm["smc-parallel"].as<bool>());
         }
 
+        if(vm.count("smc-threads")) {
+            opts.setSmcThreads(vm["smc-threads"].as<unsigned int>());
+        }
+
+        if(vm.count("smc-batch")) {
+            opts.setSmcBatch(vm["smc-batch"].as<unsigned int>());
+        }
+
+        if(vm.count("smc-splitting")) {
+            opts.setSmcSplitting(vm["smc-splitting"].as<unsigned int>());
+        }
+
+        if(vm.count("smc-splitting-replications")) {
+            opts.setSmcSplittingReplications(std::max(2u, vm["smc-splitting-replications"].as<unsigned int>()));
+        }
+
+        if(vm.count("seed")) {
+            opts.setSeed(vm["seed"].as<uint64_t>());
+        }
+
         if(vm.count("smc-print-cumulative-stats")) {
             opts.setPrintCumulative(true);
             if(!vm["smc-print-cumulative-stats"].empty()) {
@@ -297,6 +344,15 @@ namespace VerifyTAPN {
             );
         }
 
+        if(vm.count("smc-estimation-method")) {
+            unsigned int method = vm["smc-estimation-method"].as<unsigned int>();
+            opts.setSMCEstimationMethod(
+                method == 1 ? VerificationOptions::WILSON_ESTIMATION :
+                method == 2 ? VerificationOptions::BAYESIAN_ESTIMATION :
+                VerificationOptions::FIXED_ESTIMATION
+            );
+        }
+
         if(vm.count("smc-numeric-precision")) {
             opts.setSMCNumericPrecision(vm["smc-numeric-precision"].as<unsigned int>());
         }
@@ -56,6 +56,7 @@ namespace VerifyTAPN {
         out << "Verification method: " << VerificationTypeEnumToString(options.getVerificationType()) << std::endl;
         out << "Memory optimization: " << MemoryOptimizationEnumToString(options.getMemoryOptimization()) << std::endl;
         out << "Partial Order Reduction: " << (options.getPartialOrderReduction() ? "Enabled" : "Disabled")
+            << (options.getPartialOrderReduction() && options.getQueryGuidedReduction() ? " (query guided)" : "")
             << std::endl;
         out << "k-bound is: " << options.getKBound() << std::endl;
         out << "Generating " << enumToString(options.getTrace()) << " trace";
@@ -75,6 +76,9 @@ namespace VerifyTAPN {
                 out << "Bound is : " << options.getWorkflowBound() << std::endl;
             }
         }
+        if (!options.getStateSpaceCache().empty()) {
+            out << "State-space cache: " << options.getStateSpaceCache() << std::endl;
+        }
         if (options.getCalculateCmax()) {
             out << "Calculating C-max" << std::endl;
         }
@@ -0,0 +1,76 @@
+/*
+ * ConcurrentTimeDartStore.cpp
+ *
+ * Passed/waiting store of time darts shared by the workers of the parallel time dart reachability search.
+ */
+
+#include "DiscreteVerification/DataStructures/ConcurrentTimeDartStore.hpp"
+
+namespace VerifyTAPN { namespace DiscreteVerification {
+
+    bool ConcurrentTimeDart::claim(int &from, int &to) {
+        queued.store(false, std::memory_order_seq_cst);
+        int w = waiting.load(std::memory_order_seq_cst);
+        int p = passed.load(std::memory_order_relaxed);
+        while (w < p) {
+            if (passed.compare_exchange_weak(p, w, std::memory_order_acq_rel)) {
+                from = w;
+                to = p - 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ConcurrentTimeDartStore::ConcurrentTimeDartStore(size_t shards)
+            : nshards(shards), shards(new Shard[shards]) {
+    }
+
+    ConcurrentTimeDartStore::~ConcurrentTimeDartStore() {
+        for (size_t i = 0; i < nshards; ++i) {
+            for (auto &bucket : shards[i].darts) {
+                for (auto *dart : bucket.second) {
+                    delete dart->base;
+                    delete dart;
+                }
+            }
+        }
+    }
+
+    std::pair<ConcurrentTimeDart *, bool> ConcurrentTimeDartStore::add(NonStrictMarkingBase *marking, int youngest) {
+        size_t hash = marking->getHashKey();
+        Shard &shard = shards[hash % nshards];
+        ConcurrentTimeDart *dart = nullptr;
+        {
+            std::lock_guard<std::mutex> guard(shard.lock);
+            std::vector<ConcurrentTimeDart *> &bucket = shard.darts[hash];
+            for (auto *candidate : bucket) {
+                if (candidate->base->equals(*marking)) {
+                    dart = candidate;
+                    break;
+                }
+            }
+            if (dart == nullptr) {
+                dart = new ConcurrentTimeDart(marking, youngest);
+                bucket.push_back(dart);
+                stored.fetch_add(1, std::memory_order_relaxed);
+                return std::make_pair(dart, true);
+            }
+        }
+        delete marking;
+
+        int w = dart->waiting.load(std::memory_order_relaxed);
+        while (youngest < w) {
+            if (dart->waiting.compare_exchange_weak(w, youngest, std::memory_order_seq_cst)) {
+                // the dart must be explored again from youngest, unless that part is already passed or queued
+                if (youngest < dart->passed.load(std::memory_order_seq_cst) &&
+                    !dart->queued.exchange(true, std::memory_order_seq_cst)) {
+                    return std::make_pair(dart, false);
+                }
+                break;
+            }
+        }
+        return std::make_pair(nullptr, false);
+    }
+
+} } /* namespace VerifyTAPN */
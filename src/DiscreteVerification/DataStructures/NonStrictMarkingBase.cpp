@@ -332,13 +332,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             }
         }
 
-        if (!hasOutArc) {
-            delete[] status;
-            return true; // if no outgoing arcs, we have a deadlock!
-        }
-
-
-        // if any transition is enabled there is no deadlock
+        // if any transition is enabled there is no deadlock (also the ones with only inhibitor arcs)
         for (int i = 0; i < count; ++i) {
             if (status[i] == 0) {
                 delete[] status;
@@ -346,6 +340,11 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             }
         }
         delete[] status;
+
+        if (!hasOutArc) {
+            return true; // if no outgoing arcs, we have a deadlock!
+        }
+
         // if we can delay there is no deadlock (needs something with check for possible delay)
         if (canDelay &&
             !ignoreCanDelay) {       // for sure we have a deadlock if all tokens are at MC +1 and we can delay
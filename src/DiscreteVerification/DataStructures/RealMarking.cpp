@@ -52,6 +52,20 @@ RealMarking::RealMarking(const RealMarking& other)
 {
     places = other.places;
     deadlocked = other.deadlocked;
+    clock = other.clock;
+    invariantDeadline = other.invariantDeadline;
+    invariantDeadlineValid = other.invariantDeadlineValid;
+}
+
+RealMarking& RealMarking::operator=(const RealMarking& other)
+{
+    places = other.places;
+    deadlocked = other.deadlocked;
+    clock = other.clock;
+    generatedBy = other.generatedBy;
+    fromDelay = other.fromDelay;
+    invariantDeadlineValid = false;
+    return *this;
 }
 
 uint32_t RealMarking::size() const
@@ -63,23 +77,6 @@ uint32_t RealMarking::size() const
     return size;
 }
 
-RealPlaceList& RealMarking::getPlaceList()
-{
-    return places;
-}
-
-RealTokenList& RealMarking::getTokenList(int placeId)
-{
-    return places[placeId].tokens;
-}
-
-void RealMarking::deltaAge(double x)
-{
-    for(auto& place : places) {
-        place.deltaAge(x);
-    }
-}
-
 NonStrictMarkingBase RealMarking::generateImage()
 {
     NonStrictMarkingBase marking;
@@ -114,36 +111,47 @@ bool RealMarking::removeToken(int placeId, RealToken& token)
 
 bool RealMarking::removeToken(RealPlace &place, RealToken &token)
 {
+    invariantDeadlineValid = false;
     return place.remove(token);
 }
 
 void RealMarking::addTokenInPlace(TAPN::TimedPlace &place, double age)
 {
-    RealToken token(age, 1);
+    RealToken token(age - clock, 1);
     addTokenInPlace(place, token);
 }
 
 void RealMarking::addTokenInPlace(RealPlace &place, RealToken &token)
 {
+    invariantDeadlineValid = false;
     place.add(token);
 }
 
 void RealMarking::addTokenInPlace(const TAPN::TimedPlace &place, RealToken &token)
 {
+    invariantDeadlineValid = false;
     places[place.getIndex()].add(token);
 }
 
-double RealMarking::availableDelay() const
+double RealMarking::getInvariantDeadline() const
 {
-    double available = std::numeric_limits<double>::infinity();
-    for(const auto& place : places) {
-        if(place.isEmpty()) continue;
-        double delay = place.availableDelay();
-        if(delay < available) {
-            available = delay;
+    // The deadline is a clock value, so it only changes when tokens are added or removed
+    if(!invariantDeadlineValid) {
+        invariantDeadline = std::numeric_limits<double>::infinity();
+        for(const auto& place : places) {
+            invariantDeadline = std::min(invariantDeadline, place.invariantDeadline());
         }
+        invariantDeadlineValid = true;
     }
-    return available;
+    return invariantDeadline;
+}
+
+double RealMarking::availableDelay() const
+{
+    double deadline = getInvariantDeadline();
+    if(deadline == std::numeric_limits<double>::infinity()) return deadline;
+    double delay = deadline - clock;
+    return delay <= 0.0f ? 0.0f : delay;
 }
 
 void RealMarking::setDeadlocked(const bool dead) 
@@ -154,7 +162,7 @@ void RealMarking::setDeadlocked(const bool dead)
 bool RealMarking::enables(TAPN::TimedTransition* transition) {
     for(auto input : transition->getInhibitorArcs()) {
         uint32_t weight = input->getWeight();
-        RealTokenList tokens = getTokenList(input->getInputPlace().getIndex());
+        const RealTokenList& tokens = places[input->getInputPlace().getIndex()].tokens;
         for(auto& token : tokens) {
             if(token.getCount() > weight) {
                 weight = 0;
@@ -168,9 +176,9 @@ bool RealMarking::enables(TAPN::TimedTransition* transition) {
     for(auto input : transition->getPreset()) {
         TAPN::TimeInterval interval = input->getInterval();
         uint32_t weight = input->getWeight();
-        RealTokenList tokens = getTokenList(input->getInputPlace().getIndex());
+        const RealTokenList& tokens = places[input->getInputPlace().getIndex()].tokens;
         for(auto& token : tokens) {
-            if(interval.contains(token.getAge())) {
+            if(interval.contains(getAge(token))) {
                 if(token.getCount() > weight) {
                     weight = 0;
                 } else {
@@ -187,9 +195,9 @@ bool RealMarking::enables(TAPN::TimedTransition* transition) {
         if(outputPlace.getInvariant().getBound() < interval.getUpperBound())
             interval.setUpperBound(outputPlace.getInvariant().getBound(), false);
         uint32_t weight = input->getWeight();
-        RealTokenList tokens = getTokenList(input->getSource().getIndex());
+        const RealTokenList& tokens = places[input->getSource().getIndex()].tokens;
         for(auto& token : tokens) {
-            if(interval.contains(token.getAge())) {
+            if(interval.contains(getAge(token))) {
                 if(token.getCount() > weight) {
                     weight = 0;
                 } else {
@@ -0,0 +1,103 @@
+/*
+ * ReverseEdgeStore.cpp
+ *
+ * Edges of an explored state space, kept for a backward reachability pass once the exploration is over.
+ */
+
+#include "DiscreteVerification/DataStructures/ReverseEdgeStore.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <thread>
+
+// Smallest number of states per thread for a level to be split
+#define BACKWARD_LEVEL_CHUNK 4096
+
+namespace VerifyTAPN { namespace DiscreteVerification {
+
+    void ReverseEdgeStore::compress(size_t states) {
+        if (edges.empty() && offsets.size() == states + 1) return;    // already compressed
+        assert(sources.empty());    // states or edges added after a backward pass are not supported
+        offsets.assign(states + 1, 0);
+        for (const auto &edge : edges) {
+            ++offsets[edge.second + 1];
+        }
+        for (size_t s = 0; s < states; ++s) {
+            offsets[s + 1] += offsets[s];
+        }
+        sources.resize(edges.size());
+        std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+        for (const auto &edge : edges) {
+            sources[next[edge.second]++] = edge.first;
+        }
+        std::vector<std::pair<uint32_t, uint32_t>>().swap(edges);
+    }
+
+    size_t ReverseEdgeStore::backwardReachable(size_t states, const std::vector<uint32_t> &targets, size_t threads,
+                                               std::vector<bool> &reached) {
+        compress(states);
+
+        std::unique_ptr<std::atomic<bool>[]> visited(new std::atomic<bool>[states]);
+        for (size_t s = 0; s < states; ++s) {
+            visited[s].store(false, std::memory_order_relaxed);
+        }
+
+        std::vector<uint32_t> level;
+        for (uint32_t target : targets) {
+            if (!visited[target].exchange(true, std::memory_order_relaxed)) {
+                level.push_back(target);
+            }
+        }
+
+        auto expand = [&](size_t begin, size_t end, std::vector<uint32_t> &next) {
+            for (size_t i = begin; i < end; ++i) {
+                uint32_t state = level[i];
+                for (uint32_t e = offsets[state]; e < offsets[state + 1]; ++e) {
+                    uint32_t source = sources[e];
+                    if (!visited[source].load(std::memory_order_relaxed) &&
+                        !visited[source].exchange(true, std::memory_order_relaxed)) {
+                        next.push_back(source);
+                    }
+                }
+            }
+        };
+
+        size_t count = 0;
+        std::vector<std::vector<uint32_t>> next(std::max<size_t>(threads, 1));
+        while (!level.empty()) {
+            count += level.size();
+            size_t workers = std::min(next.size(), (level.size() + BACKWARD_LEVEL_CHUNK - 1) / BACKWARD_LEVEL_CHUNK);
+            if (workers <= 1) {
+                next[0].clear();
+                expand(0, level.size(), next[0]);
+                level.swap(next[0]);
+                continue;
+            }
+
+            std::vector<std::thread> handles;
+            handles.reserve(workers);
+            for (size_t w = 0; w < workers; ++w) {
+                next[w].clear();
+                handles.emplace_back([&, w]() {
+                    expand(level.size() * w / workers, level.size() * (w + 1) / workers, next[w]);
+                });
+            }
+            for (auto &handle : handles) {
+                handle.join();
+            }
+            level.clear();
+            for (size_t w = 0; w < workers; ++w) {
+                level.insert(level.end(), next[w].begin(), next[w].end());
+            }
+        }
+
+        reached.assign(states, false);
+        for (size_t s = 0; s < states; ++s) {
+            if (visited[s].load(std::memory_order_relaxed)) reached[s] = true;
+        }
+        return count;
+    }
+
+} } /* namespace VerifyTAPN */
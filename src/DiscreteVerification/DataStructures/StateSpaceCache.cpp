@@ -0,0 +1,155 @@
+#include "DiscreteVerification/DataStructures/StateSpaceCache.hpp"
+#include "DiscreteVerification/QueryVisitor.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace VerifyTAPN { namespace DiscreteVerification {
+
+    static const char cacheMagic[8] = {'V', 'D', 'T', 'A', 'P', 'N', 'S', 'S'};
+    static const uint32_t cacheVersion = 1;
+
+    template<typename T>
+    static inline void writeRaw(std::ostream &out, T value) {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    static inline bool readRaw(std::istream &in, T &value) {
+        return (bool) in.read(reinterpret_cast<char *>(&value), sizeof(T));
+    }
+
+    // FNV-1a, std::hash gives no guarantees across builds.
+    static uint64_t hashString(const std::string &s) {
+        uint64_t h = 14695981039346656037ULL;
+        for (unsigned char c : s) {
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    StateSpaceCache::StateSpaceCache(const TAPN::TimedArcPetriNet &tapn, const std::vector<int> &initialPlacement,
+                                     const VerificationOptions &options)
+            : tapn(tapn), file(options.getStateSpaceCache()) {
+        std::stringstream ss;
+        tapn.print(ss);
+        ss << "Initial:";
+        for (int p : initialPlacement) ss << " " << p;
+        ss << std::endl << "k-bound: " << options.getKBound() << std::endl;
+        ss << "GCD: " << tapn.getGCD() << std::endl;
+        key = hashString(ss.str());
+    }
+
+    bool StateSpaceCache::readHeader(std::ifstream &in) {
+        char magic[sizeof(cacheMagic)];
+        uint32_t version;
+        uint64_t fileKey;
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, cacheMagic, sizeof(magic)) != 0) return false;
+        if (!readRaw(in, version) || version != cacheVersion) return false;
+        if (!readRaw(in, fileKey) || fileKey != key) return false;
+        return readRaw(in, count) && readRaw(in, maxTokens);
+    }
+
+    void StateSpaceCache::writeHeader() {
+        out.write(cacheMagic, sizeof(cacheMagic));
+        writeRaw(out, cacheVersion);
+        writeRaw(out, key);
+        writeRaw(out, count);
+        writeRaw(out, maxTokens);
+    }
+
+    bool StateSpaceCache::load() {
+        std::ifstream in(file, std::ios::binary);
+        return in && readHeader(in);
+    }
+
+    void StateSpaceCache::beginWrite() {
+        count = 0;
+        maxTokens = 0;
+        // Stream into a temporary file and only rename it in endWrite, so an interrupted run never leaves a
+        // partial cache behind that load() would accept.
+        out.open(tmpFile(), std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cout << "Could not open state-space cache " << tmpFile() << " for writing." << std::endl;
+            std::exit(1);
+        }
+        writeHeader();
+    }
+
+    void StateSpaceCache::write(const NonStrictMarking &marking) {
+        const PlaceList &places = marking.getPlaceList();
+        writeRaw(out, (uint32_t) places.size());
+        for (const auto &place : places) {
+            writeRaw(out, (uint32_t) place.place->getIndex());
+            writeRaw(out, (uint32_t) place.tokens.size());
+            for (const auto &token : place.tokens) {
+                writeRaw(out, (int32_t) token.getAge());
+                writeRaw(out, (int32_t) token.getCount());
+            }
+        }
+        ++count;
+    }
+
+    void StateSpaceCache::endWrite(int maxTokens) {
+        this->maxTokens = maxTokens;
+        // The number of markings is only known now, rewrite the header in place.
+        out.seekp(0);
+        writeHeader();
+        out.close();
+        if (!out || std::rename(tmpFile().c_str(), file.c_str()) != 0) {
+            std::cout << "Could not write state-space cache " << file << "." << std::endl;
+            std::remove(tmpFile().c_str());
+            std::exit(1);
+        }
+    }
+
+    bool StateSpaceCache::find(AST::Query *query) {
+        std::ifstream in(file, std::ios::binary);
+        if (!in || !readHeader(in)) {
+            std::cout << "State-space cache " << file << " is not valid for this model." << std::endl;
+            std::exit(1);
+        }
+        const TAPN::TimedPlace::Vector &netPlaces = tapn.getPlaces();
+        for (uint64_t i = 0; i < count; ++i) {
+            NonStrictMarking marking;
+            uint32_t numPlaces;
+            if (!readRaw(in, numPlaces)) {
+                std::cout << "State-space cache " << file << " is truncated." << std::endl;
+                std::exit(1);
+            }
+            for (uint32_t p = 0; p < numPlaces; ++p) {
+                uint32_t index, numTokens;
+                if (!readRaw(in, index) || !readRaw(in, numTokens)) {
+                    std::cout << "State-space cache " << file << " is truncated." << std::endl;
+                    std::exit(1);
+                }
+                if (index >= netPlaces.size()) {
+                    std::cout << "State-space cache " << file << " is corrupt." << std::endl;
+                    std::exit(1);
+                }
+                Place place(netPlaces[index]);
+                for (uint32_t t = 0; t < numTokens; ++t) {
+                    int32_t age, tokenCount;
+                    readRaw(in, age);
+                    readRaw(in, tokenCount);
+                    place.tokens.emplace_back(age, tokenCount);
+                }
+                marking.getPlaceList().push_back(place);
+            }
+            if (!in) {
+                std::cout << "State-space cache " << file << " is truncated." << std::endl;
+                std::exit(1);
+            }
+
+            QueryVisitor<NonStrictMarking> checker(marking, tapn);
+            AST::BoolResult context;
+            query->accept(checker, context);
+            if (context.value) return true;
+        }
+        return false;
+    }
+
+} }
@@ -4,7 +4,8 @@
 
 namespace VerifyTAPN { namespace DiscreteVerification {
 
-    WorkflowPWList::WorkflowPWList(WaitingList<NonStrictMarking *> *w_l) : PWList(w_l, false) {
+    WorkflowPWList::WorkflowPWList(WaitingList<NonStrictMarking *> *w_l, bool coverage)
+            : PWList(w_l, false), coverage(coverage) {
     }
 
     bool WorkflowPWList::add(NonStrictMarking *marking) {
@@ -17,96 +18,21 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         }
         stored++;
         m.push_back(marking);
+        if (coverage) coveredIndex.add(*marking, marking);
         waiting_list->add(marking, marking);
         return true;
     }
 
-    NonStrictMarking *WorkflowPWList::getCoveredMarking(NonStrictMarking *marking, bool useLinearSweep) {
-        if (useLinearSweep) {
-            for (auto& el : markings_storage) {
-                for (auto* m_iter : el.second) {
-                    if (m_iter->size() >= marking->size()) {
-                        continue;
-                    }
-
-                    // Test if m_iter is covered by marking
-                    auto marking_place_iter = marking->getPlaceList().begin();
-
-                    bool tokensCovered = true;
-                    for (auto& m_place_iter : m_iter->getPlaceList()) {
-                        while (marking_place_iter != marking->getPlaceList().end() &&
-                               marking_place_iter->place != m_place_iter.place) {
-                            ++marking_place_iter;
-                        }
-
-                        if (marking_place_iter == marking->getPlaceList().end()) {
-                            tokensCovered = false;
-                            break; // Place not covered in marking
-                        }
-
-                        auto marking_token_iter = marking_place_iter->tokens.begin();
-                        for (auto& m_token_iter : m_place_iter.tokens) {
-                            while (marking_token_iter != marking_place_iter->tokens.end() &&
-                                   marking_token_iter->getAge() != m_token_iter.getAge()) {
-                                ++marking_token_iter;
-                            }
-
-                            if (marking_token_iter == marking_place_iter->tokens.end() ||
-                                marking_token_iter->getCount() < m_token_iter.getCount()) {
-                                tokensCovered = false;
-                                break;
-                            }
-                        }
-
-                        if (!tokensCovered) break;
-                    }
-
-                    if (tokensCovered) {
-                        return m_iter;
-                    }
-                }
-            }
-        } else {
-            std::vector<NonStrictMarking *> coveredMarkings;
-            coveredMarkings.push_back(new NonStrictMarking(*marking));
-            for (const auto &p_iter : marking->getPlaceList()) {
-                for (auto& t_iter : p_iter.tokens) {
-                    for (int i = 1; i <= t_iter.getCount(); ++i) {
-                        std::vector<NonStrictMarking *> toAdd;
-                        for (auto &coveredMarking : coveredMarkings) {
-                            auto *new_marking = new NonStrictMarking(*coveredMarking);
-                            for (int ii = i; ii > 0; --ii) {
-                                new_marking->removeToken(p_iter.place->getIndex(), t_iter.getAge());
-                            }
-                            toAdd.push_back(new_marking);
-                        }
-                        for (auto &iter : toAdd) {
-                            coveredMarkings.push_back(iter);
-                        }
-                    }
-                }
-            }
-
-            bool isFirst = true;
-            for (auto iter = coveredMarkings.begin();
-                 iter != coveredMarkings.end(); ++iter) {
-                if (isFirst) {
-                    isFirst = false;
-                    continue;
-                }
-                NonStrictMarking *covered = lookup(*iter);
-                if (covered != nullptr) {
-                    // cleanup
-                    for (; iter != coveredMarkings.end(); ++iter) {
-                        delete *iter;
-                    }
-                    return covered;
-                }
-                delete *iter;
+    NonStrictMarking *WorkflowPWList::getCoveredMarking(NonStrictMarking *marking) {
+        NonStrictMarking *covered = nullptr;
+        coveredIndex.find(*marking, [&](NonStrictMarking *stored) {
+            if (CoveredMarkingIndex<NonStrictMarking *>::covers(*marking, *stored)) {
+                covered = stored;
+                return true;
             }
-
-        }
-        return nullptr;
+            return false;
+        });
+        return covered;
     }
 
     NonStrictMarking *WorkflowPWList::getUnpassed() {
@@ -122,8 +48,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         return nullptr;
     }
 
-    NonStrictMarking *WorkflowPWList::addToPassed(
-            NonStrictMarking *marking, bool strong) {
+    NonStrictMarking *WorkflowPWList::addToPassed(NonStrictMarking *marking) {
         discoveredMarkings++;
         NonStrictMarking *existing = lookup(marking);
         if (existing != nullptr) {
@@ -134,9 +59,9 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             NonStrictMarkingList &m = markings_storage[marking->getHashKey()];
             stored++;
             m.push_back(marking);
+            if (coverage) coveredIndex.add(*marking, marking);
 
-            if (strong) marking->meta = new MetaData();
-            else marking->meta = new WorkflowSoundnessMetaData();
+            marking->meta = new WorkflowSoundnessMetaData();
 
             return nullptr;
         }
@@ -158,9 +83,10 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             WaitingList<ptriepointer_t<MetaData *> > *w_l,
             int knumber,
             int nplaces,
-            int mage)
+            int mage,
+            bool coverage)
             : PWListHybrid(tapn, w_l, knumber, nplaces, mage, false, true),
-              visitor(encoder) {
+              coverage(coverage) {
 
     }
 
@@ -172,16 +98,20 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         }
     }
 
-    NonStrictMarking *WorkflowPWListHybrid::getCoveredMarking
-            (NonStrictMarking *marking, bool useLinearSweep) {
-        visitor.set_target(marking, last_pointer);
-        passed.visit(visitor);
-        if (visitor.found()) {
-            NonStrictMarking *m = visitor.decode();
-            return m;
-        } else {
-            return nullptr;
-        }
+    NonStrictMarking *WorkflowPWListHybrid::getCoveredMarking(NonStrictMarking *marking) {
+        NonStrictMarking *covered = nullptr;
+        coveredIndex.find(*marking, [&](uint index) {
+            ptriepointer_t<MetaData *> pointer(&passed, index);
+            NonStrictMarking *stored = encoder.decode(pointer);
+            if (CoveredMarkingIndex<uint>::covers(*marking, *stored)) {
+                stored->meta = pointer.get_meta();
+                covered = stored;
+                return true;
+            }
+            delete stored;
+            return false;
+        });
+        return covered;
     }
 
     NonStrictMarking *WorkflowPWListHybrid::getUnpassed() {
@@ -214,6 +144,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             res.second.set_meta(meta);
 
             stored++;
+            if (coverage) coveredIndex.add(*marking, res.second.index);
 
             // using min first waiting-list, weight is allready in pointer
             waiting_list->add(nullptr, res.second);
@@ -221,8 +152,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         }
     }
 
-    NonStrictMarking *WorkflowPWListHybrid::addToPassed
-            (NonStrictMarking *marking, bool strong) {
+    NonStrictMarking *WorkflowPWListHybrid::addToPassed(NonStrictMarking *marking) {
         discoveredMarkings++;
         std::pair<bool, ptriepointer_t<MetaData *> > res =
                 passed.insert(encoder.encode(marking));
@@ -240,8 +170,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         } else {
             stored++;
 
-            if (strong) marking->meta = new MetaDataWithTraceAndEncoding();
-            else marking->meta = new WorkflowSoundnessMetaDataWithEncoding();
+            marking->meta = new WorkflowSoundnessMetaDataWithEncoding();
 
             auto *meta =
                     (MetaDataWithTraceAndEncoding *) marking->meta;
@@ -252,6 +181,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
 
             res.second.set_meta(meta);
             last_pointer = res.second;
+            if (coverage) coveredIndex.add(*marking, res.second.index);
             return nullptr;
         }
     }
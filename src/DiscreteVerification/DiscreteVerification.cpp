@@ -21,6 +21,15 @@ namespace VerifyTAPN { namespace DiscreteVerification {
     void ComputeAndPrint(TAPN::TimedArcPetriNet &tapn, SMCVerification &verifier, VerificationOptions &options,
                         AST::Query *query);
 
+    void VerifyWithCacheAndPrint(TAPN::TimedArcPetriNet &tapn, NonStrictMarking &initialMarking,
+                                 const std::vector<int> &initialPlacement, AST::Query *query,
+                                 VerificationOptions &options);
+
+    template<typename B>
+    void VerifySharedAndPrint(TAPN::TimedArcPetriNet &tapn, SharedReachabilitySearch<B> &verifier,
+                              const std::vector<AST::Query *> &queries, VerificationOptions &options,
+                              std::vector<bool> &results);
+
     DiscreteVerification::DiscreteVerification() {
         // TODO Auto-generated constructor stub
 
@@ -205,10 +214,17 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             } else if(smcQuery->getSmcSettings().compareToFloat) {
                 ProbabilityFloatComparison estimator(tapn, marking, smcQuery, options);
                 ComputeAndPrint(tapn, estimator, options, query);
+            } else if(options.getSmcSplitting() > 0) {
+                ProbabilitySplitting estimator(tapn, marking, smcQuery, options);
+                ComputeAndPrint(tapn, estimator, options, query);
             } else {
                 ProbabilityEstimation estimator(tapn, marking, smcQuery, options);
                 ComputeAndPrint(tapn, estimator, options, query);
             }
+        } else if (options.getVerificationType() == VerificationOptions::DISCRETE &&
+                   !options.getStateSpaceCache().empty() &&
+                   (query->getQuantifier() == EF || query->getQuantifier() == AG)) {
+            VerifyWithCacheAndPrint(tapn, *initialMarking, initialPlacement, query, options);
         } else if (options.getVerificationType() == VerificationOptions::DISCRETE) {
             if (options.getMemoryOptimization() == VerificationOptions::PTRIE) {
                 //TODO fix initialization
@@ -275,12 +291,6 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             }
         } else if (options.getVerificationType() == VerificationOptions::TIMEDART) {
             if (query->getQuantifier() == EG || query->getQuantifier() == AF) {
-                if (containsDeadlock.value) {
-                    std::cout
-                            << "The combination of TimeDarts, Deadlock proposition and EG or AF queries is currently not supported"
-                            << std::endl;
-                   std::exit(1);
-                }
                 if (options.getMemoryOptimization() == VerificationOptions::PTRIE) {
                     WaitingList<std::pair<WaitingDart *, ptriepointer_t<LivenessDart *> > > *strategy = getWaitingList<std::pair<WaitingDart *, ptriepointer_t<LivenessDart *> > >(
                             query, options);
@@ -317,6 +327,16 @@ namespace VerifyTAPN { namespace DiscreteVerification {
                             options,
                             query);
                     delete strategy;
+                } else if (options.getThreads() != 1 && options.getTrace() == VerificationOptions::NO_TRACE &&
+                           !options.getPartialOrderReduction()) {
+                    ParallelTimeDartReachabilitySearch verifier = ParallelTimeDartReachabilitySearch(tapn,
+                                                                                                     *initialMarking,
+                                                                                                     query, options);
+                    VerifyAndPrint(
+                            tapn,
+                            verifier,
+                            options,
+                            query);
                 } else {
                     WaitingList<TimeDartBase *> *strategy = getWaitingList<TimeDartBase *>(query, options);
                     TimeDartReachabilitySearch verifier = TimeDartReachabilitySearch(tapn, *initialMarking, query,
@@ -334,6 +354,120 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         return 0;
     }
 
+    int
+    DiscreteVerification::run(TAPN::TimedArcPetriNet &tapn, const std::vector<int>& initialPlacement,
+                              const std::vector<AST::Query *> &queries, VerificationOptions &options,
+                              std::vector<bool> &results) {
+        if (!tapn.isNonStrict()) {
+            std::cout << "The supplied net contains strict intervals." << std::endl;
+            return -1;
+        }
+
+        NonStrictMarking *initialMarking = new NonStrictMarking(tapn, initialPlacement);
+
+        std::cout << "MC: " << tapn.getMaxConstant() << std::endl;
+
+        if (initialMarking->size() > options.getKBound()) {
+            std::cout << "The specified k-bound is less than the number of tokens in the initial markings.";
+            return 1;
+        }
+
+        for (auto *query : queries) {
+            assert(query->getQuantifier() == EF || query->getQuantifier() == AG);
+            AST::BoolResult containsDeadlock;
+            DeadlockVisitor deadlockVisitor = DeadlockVisitor();
+            deadlockVisitor.visit(*query, containsDeadlock);
+            if (containsDeadlock.value && options.getGCDLowerGuardsEnabled()) {
+                std::cout
+                        << "Lowering constants by greatest common divisor is unsound for queries containing the deadlock proposition"
+                        << std::endl;
+                std::exit(1);
+            }
+        }
+
+        // The successor generator is shared by all queries, so the (query dependent) stubborn sets cannot be used.
+        options.setPartialOrderReduction(false);
+        std::cout << options;
+
+        if (options.getMemoryOptimization() == VerificationOptions::PTRIE) {
+            WaitingList<ptriepointer_t<MetaData *> > *strategy = getWaitingList<ptriepointer_t<MetaData *> >(
+                    queries.front(), options);
+            SharedReachabilitySearch<ReachabilitySearchPTrie<Generator> > verifier(tapn, *initialMarking, queries,
+                                                                                  options, strategy);
+            VerifySharedAndPrint(tapn, verifier, queries, options, results);
+            delete strategy;
+        } else {
+            WaitingList<NonStrictMarking *> *strategy = getWaitingList<NonStrictMarking *>(queries.front(), options);
+            SharedReachabilitySearch<ReachabilitySearch<Generator> > verifier(tapn, *initialMarking, queries,
+                                                                             options, strategy);
+            VerifySharedAndPrint(tapn, verifier, queries, options, results);
+            delete strategy;
+        }
+
+        return 0;
+    }
+
+    void VerifyWithCacheAndPrint(TAPN::TimedArcPetriNet &tapn, NonStrictMarking &initialMarking,
+                                 const std::vector<int> &initialPlacement, AST::Query *query,
+                                 VerificationOptions &options) {
+        StateSpaceCache cache(tapn, initialPlacement, options);
+        if (cache.load()) {
+            std::cout << "Using state-space cache " << cache.getFile() << " (" << cache.size() << " markings)"
+                      << std::endl << std::endl;
+        } else {
+            WaitingList<NonStrictMarking *> *strategy = getWaitingList<NonStrictMarking *>(query, options);
+            StateSpaceCacheSearch explorer(tapn, initialMarking, query, options, strategy, cache);
+            explorer.run();
+            std::cout << std::endl;
+            explorer.printStats();
+            explorer.printTransitionStatistics();
+            explorer.printPlaceStatistics();
+            std::cout << "Wrote state-space cache " << cache.getFile() << " (" << cache.size() << " markings)"
+                      << std::endl;
+            delete strategy;
+        }
+
+        bool result = cache.find(query);
+        if (query->getQuantifier() == AG) result = !result;
+
+        std::cout << "Query is " << (result ? "satisfied" : "NOT satisfied") << "." << std::endl;
+        std::cout << "Max number of tokens found in any reachable marking: ";
+        if (cache.maxUsedTokens() > (int) options.getKBound())
+            std::cout << ">" << options.getKBound() << std::endl;
+        else
+            std::cout << cache.maxUsedTokens() << std::endl;
+    }
+
+    template<typename B>
+    void VerifySharedAndPrint(TAPN::TimedArcPetriNet &tapn, SharedReachabilitySearch<B> &verifier,
+                              const std::vector<AST::Query *> &queries, VerificationOptions &options,
+                              std::vector<bool> &results) {
+        verifier.run();
+        Verification<NonStrictMarking> &base = verifier;
+
+        if (options.getGCDLowerGuardsEnabled()) {
+            std::cout << "Lowering all guards by greatest common divisor: " << tapn.getGCD() << std::endl;
+        }
+        std::cout << std::endl;
+
+        verifier.printStats();
+        verifier.printTransitionStatistics();
+        verifier.printPlaceStatistics();
+
+        std::cout << "Queries decided during exploration: " << verifier.numberOfDecided() << " of "
+                  << queries.size() << std::endl;
+        std::cout << "Max number of tokens found in any reachable marking: ";
+        if (base.maxUsedTokens() > options.getKBound())
+            std::cout << ">" << options.getKBound() << std::endl;
+        else
+            std::cout << base.maxUsedTokens() << std::endl;
+
+        results.resize(queries.size());
+        for (size_t i = 0; i < queries.size(); ++i) {
+            results[i] = queries[i]->getQuantifier() == AG ? !verifier.isDecided(i) : verifier.isDecided(i);
+        }
+    }
+
     template<typename T>
     void VerifyAndPrint(TAPN::TimedArcPetriNet &tapn, Verification<T> &verifier, VerificationOptions &options,
                         AST::Query *query) {
@@ -372,7 +506,9 @@ namespace VerifyTAPN { namespace DiscreteVerification {
 
         std::cout << "Starting SMC..." << std::endl;
 
-        if(options.isParallel()) {
+        if(options.getSmcBatch() > 0 && estimator.supportsBatchRuns()) {
+            estimator.batch_run();
+        } else if(options.isParallel()) {
             estimator.parallel_run();
         } else {
             estimator.run();
@@ -229,5 +229,11 @@ namespace VerifyTAPN {
             out << std::endl;
             out << std::endl;
         }
+
+        void Generator::addTransitionStatistics(const Generator &other) {
+            for (size_t i = 0; i < _transitionStatistics.size(); i++) {
+                _transitionStatistics[i] += other._transitionStatistics[i];
+            }
+        }
     }
 }
\ No newline at end of file
@@ -1,15 +1,122 @@
 
 #include "DiscreteVerification/Generators/InterestingVisitor.h"
 #include "DiscreteVerification/Generators/ReducingGenerator.hpp"
+#include "DiscreteVerification/Generators/RangeVisitor.h"
+#include "DiscreteVerification/QueryVisitor.hpp"
+
+#include <limits>
 
 namespace VerifyTAPN {
 namespace DiscreteVerification {
     void InterestingVisitor::clear() {
-        std::fill(_decr.begin(), _decr.end(), false);
-        std::fill(_incr.begin(), _incr.end(), false);
+        rollback(0);
         _deadlock = false;
     }
 
+    void InterestingVisitor::enable_guided(uint32_t max_tokens) {
+        if (max_tokens == 0) max_tokens = std::numeric_limits<int32_t>::max();
+        _guided = true;
+        _bounds.assign(_tapn.getPlaces().size(), {0, max_tokens});
+        _incr_cost.resize(_tapn.getPlaces().size());
+        _decr_cost.resize(_tapn.getPlaces().size());
+        for (auto* place : _tapn.getPlaces()) {
+            _incr_cost[place->getIndex()] = place->getOutputArcs().size() + place->getProdTransportArcs().size();
+            _decr_cost[place->getIndex()] = place->getInputArcs().size() + place->getTransportArcs().size();
+        }
+    }
+
+    void InterestingVisitor::mark(uint32_t place, bool incr) {
+        auto &bits = incr ? _incr : _decr;
+        if (!bits[place]) {
+            bits[place] = true;
+            _marks.push_back({place, incr});
+        }
+    }
+
+    size_t InterestingVisitor::cost_since(size_t first) const {
+        size_t cost = 0;
+        for (size_t i = first; i < _marks.size(); ++i)
+            cost += (_marks[i].incr ? _incr_cost : _decr_cost)[_marks[i].place];
+        return cost;
+    }
+
+    void InterestingVisitor::rollback(size_t first) {
+        for (size_t i = first; i < _marks.size(); ++i)
+            (_marks[i].incr ? _incr : _decr)[_marks[i].place] = false;
+        _marks.resize(first);
+    }
+
+    bool InterestingVisitor::evaluate(Expression &expr) {
+        QueryVisitor<NonStrictMarkingBase> checker(*_marking, _tapn);
+        BoolResult context;
+        expr.accept(checker, context);
+        return context.value;
+    }
+
+    void InterestingVisitor::cheapest(Expression &left, Expression &right, Result &context) {
+        size_t first = _marks.size();
+        bool deadlock = _deadlock;
+        left.accept(*this, context);
+        // a deadlock subformula is handled by a single enabled transition, count it as everything
+        size_t left_cost = _deadlock != deadlock ? std::numeric_limits<size_t>::max() : cost_since(first);
+        bool left_deadlock = _deadlock;
+        std::vector<Mark> left_marks(_marks.begin() + first, _marks.end());
+        rollback(first);
+        _deadlock = deadlock;
+
+        right.accept(*this, context);
+        size_t right_cost = _deadlock != deadlock ? std::numeric_limits<size_t>::max() : cost_since(first);
+        if (right_cost <= left_cost) return;
+        rollback(first);
+        _deadlock = left_deadlock;
+        for (auto &m : left_marks)
+            mark(m.place, m.incr);
+    }
+
+    bool InterestingVisitor::guided(AtomicProposition &expr) {
+        // the atom keeps its current value in every marking within the bounds
+        int32_t stuck = expr.eval ? 1 : -1;
+
+        _places.clear();
+        _collect = true;
+        IncDecr any(true, true);
+        expr.getLeft().accept(*this, any);
+        expr.getRight().accept(*this, any);
+        _collect = false;
+        std::sort(_places.begin(), _places.end());
+        _places.erase(std::unique(_places.begin(), _places.end()), _places.end());
+
+        RangeVisitor range(_tapn, *_marking, _bounds.data());
+        bool found = false;
+        Mark best{};
+        uint32_t best_cost = std::numeric_limits<uint32_t>::max();
+        for (auto p : _places) {
+            uint32_t tokens = _marking->numberOfTokensInPlace(p);
+            auto bounds = _bounds[p];
+            IntResult value;
+            // p never loses tokens, so it has to
+            _bounds[p] = {tokens, std::max(tokens, bounds.second)};
+            expr.accept(range, value);
+            if (value.value == stuck && _decr_cost[p] < best_cost) {
+                found = true;
+                best = {p, false};
+                best_cost = _decr_cost[p];
+            }
+            // p never gains tokens, so it has to
+            _bounds[p] = {0, tokens};
+            expr.accept(range, value);
+            if (value.value == stuck && _incr_cost[p] < best_cost) {
+                found = true;
+                best = {p, true};
+                best_cost = _incr_cost[p];
+            }
+            _bounds[p] = bounds;
+        }
+        if (found)
+            mark(best.place, best.incr);
+        return found;
+    }
+
     void InterestingVisitor::visit(NotExpression &expr, Result &context) {
         negate();
         expr.getChild().accept(*this, context);
@@ -21,7 +128,9 @@ namespace DiscreteVerification {
             expr.getLeft().accept(*this, context);
             expr.getRight().accept(*this, context);
         } else {
-            if (expr.getLeft().eval)
+            if (_guided && expr.getLeft().eval && evaluate(expr.getRight()))
+                cheapest(expr.getLeft(), expr.getRight(), context);
+            else if (expr.getLeft().eval)
                 expr.getLeft().accept(*this, context);
             else if (expr.getRight().eval)
                 expr.getRight().accept(*this, context);
@@ -33,7 +142,9 @@ namespace DiscreteVerification {
             expr.getLeft().accept(*this, context);
             expr.getRight().accept(*this, context);
         } else {
-            if (!expr.getLeft().eval)
+            if (_guided && !expr.getLeft().eval && !evaluate(expr.getRight()))
+                cheapest(expr.getLeft(), expr.getRight(), context);
+            else if (!expr.getLeft().eval)
                 expr.getLeft().accept(*this, context);
             else if (!expr.getRight().eval)
                 expr.getRight().accept(*this, context);
@@ -41,6 +152,8 @@ namespace DiscreteVerification {
     }
 
     void InterestingVisitor::visit(AtomicProposition &expr, Result &context) {
+        if (_guided && (expr.eval != 0) == _negated && guided(expr))
+            return;
         auto incdec = [this, &expr](bool id1, bool id2) {
             IncDecr ic(true, false);
             IncDecr dc(false, true);
@@ -62,12 +175,13 @@ namespace DiscreteVerification {
             case AtomicProposition::NE:
             {
                 bool neg = _negated == (expr.getOperator() == AtomicProposition::EQ);
-                if (!expr.eval && !neg) {
+                bool equal = expr.getLeft().eval == expr.getRight().eval;
+                if (!equal && !neg) {
                     if (expr.getLeft().eval < expr.getRight().eval)
                         incdec(true, false);
                     else
                         incdec(false, true);
-                } else if (expr.eval && neg) {
+                } else if (equal && neg) {
                     incdec(true, true);
                     incdec(false, false);
                 }
@@ -96,11 +210,15 @@ namespace DiscreteVerification {
     }
 
     void InterestingVisitor::visit(IdentifierExpression &expr, Result &context) {
+        if (_collect) {
+            _places.push_back(expr.getPlace());
+            return;
+        }
         auto &id = static_cast<IncDecr &> (context);
         if (id.incr)
-            _incr[expr.getPlace()] = true;
+            mark(expr.getPlace(), true);
         if (id.decr)
-            _decr[expr.getPlace()] = true;
+            mark(expr.getPlace(), false);
     }
 
     void InterestingVisitor::visit(MultiplyExpression &expr, Result &context) {
@@ -113,9 +231,9 @@ namespace DiscreteVerification {
         auto &id = static_cast<IncDecr &> (context);
         IncDecr down(false, true);
         IncDecr up(true, false);
-        if (id.incr && id.decr) expr.accept(*this, id);
-        else if (id.incr) expr.accept(*this, down);
-        else if (id.decr) expr.accept(*this, up);
+        if (id.incr && id.decr) expr.getValue().accept(*this, id);
+        else if (id.incr) expr.getValue().accept(*this, down);
+        else if (id.decr) expr.getValue().accept(*this, up);
     }
 
     void InterestingVisitor::visit(SubtractExpression &expr, Result &context) {
@@ -124,7 +242,8 @@ namespace DiscreteVerification {
         IncDecr up(true, false);
         if (id.incr && id.decr)
         {
-            expr.accept(*this, id);
+            expr.getLeft().accept(*this, id);
+            expr.getRight().accept(*this, id);
         } else if (id.incr) {
             expr.getLeft().accept(*this, up);
             expr.getRight().accept(*this, down);
@@ -44,14 +44,14 @@ namespace VerifyTAPN {
             PairResult ctxt;
             expr.getLeft().accept(*this, ctxt);
             auto lv = ctxt.value;
-            expr.getLeft().accept(*this, ctxt);
+            expr.getRight().accept(*this, ctxt);
             auto rv = ctxt.value;
             switch (expr.getOperator()) {
                 case AtomicProposition::LT:
                 {
                     if (lv.second < rv.first)
                         val.value = 1;
-                    else if (lv.first > rv.second)
+                    else if (lv.first >= rv.second)
                         val.value = -1;
                     else
                         val.value = 0;
@@ -61,7 +61,7 @@ namespace VerifyTAPN {
                 {
                     if (lv.second <= rv.first)
                         val.value = 1;
-                    else if (lv.first >= rv.second)
+                    else if (lv.first > rv.second)
                         val.value = -1;
                     else
                         val.value = 0;
@@ -182,8 +182,9 @@ namespace VerifyTAPN {
             expr.getLeft().accept(*this, context);
             auto lv = val.value;
             expr.getRight().accept(*this, context);
-            val.value.first -= lv.second;
-            val.value.second -= lv.first;
+            auto rv = val.value;
+            val.value.first = lv.first - rv.second;
+            val.value.second = lv.second - rv.first;
         }
 
         void RangeVisitor::visit(PlusExpression &expr, Result &context) {
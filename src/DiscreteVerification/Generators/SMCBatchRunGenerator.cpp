@@ -0,0 +1,563 @@
+/*
+ * File:   SMCBatchRunGenerator.cpp
+ *
+ * Simulates a batch of independent SMC runs in lockstep.
+ */
+
+#include "DiscreteVerification/Generators/SMCBatchRunGenerator.h"
+#include "DiscreteVerification/QueryVisitor.hpp"
+
+#include <random>
+#include <algorithm>
+
+namespace VerifyTAPN {
+    namespace DiscreteVerification {
+
+        using Util::interval;
+
+        namespace {
+            // Marking of one lane, as seen by the query checker
+            class LaneMarking {
+            public:
+                LaneMarking(const SMCBatchRunGenerator &generator, size_t lane) : generator(generator), lane(lane) { }
+
+                inline uint32_t numberOfTokensInPlace(int placeId) const {
+                    return generator.numberOfTokensInPlace(placeId, lane);
+                }
+
+                inline bool canDeadlock(const TAPN::TimedArcPetriNet &, int) const {
+                    return generator.deadlocked(lane);
+                }
+
+            private:
+                const SMCBatchRunGenerator &generator;
+                size_t lane;
+            };
+        }
+
+        SMCBatchRunGenerator::SMCBatchRunGenerator(TAPN::TimedArcPetriNet &tapn, size_t lanes, unsigned int numericPrecision)
+        : _tapn(tapn)
+        , _lanes(std::max<size_t>(lanes, 1))
+        , _numericPrecision(numericPrecision)
+        , _transitionsStatistics(tapn.getTransitions().size(), 0)
+        , _rng(_lanes)
+        {
+            SMCRunGenerator::computeDependencies(tapn, _affectedBy, _touchesInvariant);
+            size_t n_transitions = tapn.getTransitions().size();
+            size_t n_places = tapn.getNumberOfPlaces();
+            const double inf = std::numeric_limits<double>::infinity();
+            _clock.assign(_lanes, 0);
+            _deadline.assign(_lanes, inf);
+            _nextDate.assign(_lanes, inf);
+            _steps.assign(_lanes, 0);
+            _liveCount.assign(_lanes, 0);
+            _active.assign(_lanes, 0);
+            _run.assign(_lanes, 0);
+            _lower.assign(n_transitions * _lanes, inf);
+            _upper.assign(n_transitions * _lanes, inf);
+            _nextLower.assign(n_transitions * _lanes, inf);
+            _dates.assign(n_transitions * _lanes, inf);
+            _keys.assign(n_transitions * _lanes, inf);
+            _live.assign(n_transitions * _lanes, 0);
+            _ages.assign(n_places, std::vector<double>());
+            _slots.assign(n_places, 0);
+            _tokens.assign(n_places * _lanes, 0);
+            _random.assign(_randomBlock * _lanes, 0);
+            _randomUsed.assign(_lanes, _randomBlock);
+            _refreshed.assign(n_transitions, 0);
+            std::random_device rd;
+            setSeed(((uint64_t) rd() << 32) | rd(), 0);
+        }
+
+        void SMCBatchRunGenerator::setSeed(uint64_t seed, uint32_t stream) {
+            _rng.seed(seed, (uint64_t) stream * _lanes);
+            std::fill(_randomUsed.begin(), _randomUsed.end(), _randomBlock);
+        }
+
+        void SMCBatchRunGenerator::refillRandom() {
+            for(uint32_t k = 0 ; k < _randomBlock ; k++) {
+                _rng(&_random[k * _lanes]);
+            }
+            std::fill(_randomUsed.begin(), _randomUsed.end(), 0);
+        }
+
+        void SMCBatchRunGenerator::prepare(RealMarking *initial) {
+            _initialAges.assign(_tapn.getNumberOfPlaces(), std::vector<double>());
+            for(const RealPlace& place : initial->getPlaceList()) {
+                auto& ages = _initialAges[place.placeId()];
+                for(auto token = place.tokens.rbegin() ; token != place.tokens.rend() ; token++) {
+                    ages.insert(ages.end(), token->getCount(), initial->getAge(*token));
+                }
+                reserveSlots(place.placeId(), ages.size());
+            }
+            _initialDeadline = initial->availableDelay();
+
+            // The default windows are those of the initial marking, computed once on lane 0
+            size_t n_transitions = _tapn.getTransitions().size();
+            _defaultLower.resize(n_transitions);
+            _defaultUpper.resize(n_transitions);
+            _defaultNext.resize(n_transitions);
+            for(size_t p = 0 ; p < _initialAges.size() ; p++) {
+                const auto& ages = _initialAges[p];
+                for(size_t s = 0 ; s < ages.size() ; s++) _ages[p][s * _lanes] = ages[s];
+                _tokens[p * _lanes] = ages.size();
+            }
+            _clock[0] = 0;
+            for(size_t i = 0 ; i < n_transitions ; i++) {
+                computeFiringWindows(i, 0);
+                _defaultLower[i] = _lower[i * _lanes];
+                _defaultUpper[i] = _upper[i * _lanes];
+                _defaultNext[i] = _nextLower[i * _lanes];
+            }
+        }
+
+        void SMCBatchRunGenerator::reserveSlots(size_t place, size_t slots) {
+            if(slots <= _slots[place]) return;
+            // Slots are rows of lanes, so growing the storage keeps every token where it is
+            size_t grown = std::max(slots, 2 * _slots[place]);
+            _ages[place].resize(grown * _lanes);
+            _slots[place] = grown;
+        }
+
+        void SMCBatchRunGenerator::startRun(size_t lane, size_t run) {
+            _run[lane] = run;
+            _clock[lane] = 0;
+            _steps[lane] = 0;
+            _deadline[lane] = _initialDeadline;
+            _liveCount[lane] = 0;
+            for(size_t p = 0 ; p < _initialAges.size() ; p++) {
+                const auto& ages = _initialAges[p];
+                double* slots = _ages[p].data() + lane;
+                for(size_t s = 0 ; s < ages.size() ; s++) slots[s * _lanes] = ages[s];
+                _tokens[p * _lanes + lane] = ages.size();
+            }
+            size_t n_transitions = _defaultLower.size();
+            for(size_t i = 0 ; i < n_transitions ; i++) {
+                size_t index = i * _lanes + lane;
+                _lower[index] = _defaultLower[i];
+                _upper[index] = _defaultUpper[i];
+                _nextLower[index] = _defaultNext[i];
+                _dates[index] = std::numeric_limits<double>::infinity();
+                _live[index] = 0;
+            }
+            for(size_t i = 0 ; i < n_transitions ; i++) {
+                refreshTransition(i, lane, true);
+            }
+            _active[lane] = 1;
+        }
+
+        bool SMCBatchRunGenerator::endRun(size_t lane, AST::Query *query, int timeBound, int stepBound, std::vector<SMCRunResult> &results) {
+            bool res;
+            if(_clock[lane] >= timeBound || _steps[lane] >= stepBound) {
+                res = false;
+            } else {
+                LaneMarking marking(*this, lane);
+                QueryVisitor<LaneMarking> checker(marking, _tapn);
+                AST::BoolResult context;
+                query->accept(checker, context);
+                if(!context.value) return false;
+                res = true;
+            }
+            results[_run[lane]] = { res, std::min(_steps[lane], stepBound), std::min(_clock[lane], (double) timeBound) };
+            _active[lane] = 0;
+            return true;
+        }
+
+        void SMCBatchRunGenerator::simulate(AST::Query *query, int timeBound, int stepBound, size_t runs, std::vector<SMCRunResult> &results) {
+            results.resize(runs);
+            size_t started = 0;
+            size_t running = 0;
+            // Starts runs on the lane until one of them does not end in its initial marking
+            auto launch = [&](size_t lane) {
+                while(started < runs) {
+                    startRun(lane, started++);
+                    if(!endRun(lane, query, timeBound, stepBound, results)) {
+                        running++;
+                        return;
+                    }
+                }
+            };
+            std::fill(_active.begin(), _active.end(), 0);
+            for(size_t lane = 0 ; lane < _lanes ; lane++) {
+                launch(lane);
+            }
+
+            const size_t n_transitions = _defaultLower.size();
+            while(running > 0) {
+                double* next = _nextDate.data();
+                std::fill(_nextDate.begin(), _nextDate.end(), std::numeric_limits<double>::infinity());
+                for(size_t i = 0 ; i < n_transitions ; i++) {
+                    const double* keys = _keys.data() + i * _lanes;
+                    for(size_t lane = 0 ; lane < _lanes ; lane++) {
+                        next[lane] = keys[lane] < next[lane] ? keys[lane] : next[lane];
+                    }
+                }
+
+                for(size_t lane = 0 ; lane < _lanes ; lane++) {
+                    if(!_active[lane]) continue;
+                    if(next[lane] == std::numeric_limits<double>::infinity()) {
+                        // Maximal run
+                        results[_run[lane]] = { false, std::min(_steps[lane], stepBound), std::min(_clock[lane], (double) timeBound) };
+                        _active[lane] = 0;
+                    } else {
+                        step(lane);
+                        if(!endRun(lane, query, timeBound, stepBound, results)) continue;
+                    }
+                    running--;
+                    launch(lane);
+                }
+            }
+        }
+
+        void SMCBatchRunGenerator::step(size_t lane) {
+            const double date_min = _nextDate[lane];
+            const size_t n_transitions = _defaultLower.size();
+            _due.clear();
+            _winners.clear();
+            for(size_t i = 0 ; i < n_transitions ; i++) {
+                size_t index = i * _lanes + lane;
+                if(_keys[index] != date_min) continue;
+                _due.push_back(i);
+                if(_dates[index] == date_min) _winners.push_back(i);
+            }
+            // The clock jumps to the event date itself, so windows opening or closing at that date compare equal to now.
+            _clock[lane] = date_min;
+
+            if(++_refreshStamp == 0) {
+                std::fill(_refreshed.begin(), _refreshed.end(), 0);
+                _refreshStamp = 1;
+            }
+            bool refreshAll = false;
+            if(!_winners.empty()) {
+                size_t winner = _winners.size() == 1 ? _winners[0] : chooseWeightedWinner(lane);
+                _steps[lane]++;
+                _transitionsStatistics[winner]++;
+                _dates[winner * _lanes + lane] = std::numeric_limits<double>::infinity();
+                fire(_tapn.getTransitions()[winner], lane);
+                if(_touchesInvariant[winner]) {
+                    double deadline = std::max(_clock[lane], invariantDeadline(lane));
+                    refreshAll = deadline != _deadline[lane];
+                    _deadline[lane] = deadline;
+                }
+                for(auto i : _affectedBy[winner]) {
+                    computeFiringWindows(i, lane);
+                    if(!refreshAll) {
+                        _refreshed[i] = _refreshStamp;
+                        refreshTransition(i, lane);
+                    }
+                }
+            }
+
+            if(refreshAll) {
+                for(size_t i = 0 ; i < n_transitions ; i++) {
+                    refreshTransition(i, lane);
+                }
+            } else {
+                for(auto i : _due) {
+                    if(_refreshed[i] == _refreshStamp) continue;
+                    _refreshed[i] = _refreshStamp;
+                    refreshTransition(i, lane);
+                }
+            }
+        }
+
+        double SMCBatchRunGenerator::sample(size_t i, size_t lane) {
+            LaneEngine engine { *this, lane };
+            return _tapn.getTransitions()[i]->getDistribution().sample(engine, _numericPrecision);
+        }
+
+        void SMCBatchRunGenerator::computeFiringWindows(size_t i, size_t lane) {
+            TimedTransition* transi = _tapn.getTransitions()[i];
+            const size_t index = i * _lanes + lane;
+            const double now = _clock[lane];
+            const double inf = std::numeric_limits<double>::infinity();
+            if(transi->getPresetSize() == 0 && transi->getNumberOfInhibitorArcs() == 0) {
+                _lower[index] = now;
+                _upper[index] = inf;
+                _nextLower[index] = inf;
+                return;
+            }
+            transitionFiringDates(transi, lane, _windows);
+            if(_windows.empty()) {
+                _lower[index] = _upper[index] = _nextLower[index] = inf;
+                return;
+            }
+            _lower[index] = _windows[0].lower();
+            _upper[index] = _windows[0].upper();
+            _nextLower[index] = _windows.size() > 1 ? _windows[1].lower() : inf;
+        }
+
+        void SMCBatchRunGenerator::refreshTransition(size_t i, size_t lane, bool initial) {
+            const double now = _clock[lane];
+            const double inf = std::numeric_limits<double>::infinity();
+            const size_t index = i * _lanes + lane;
+            // Only the first window is kept, so it is recomputed rather than dropped once it has expired
+            if(_upper[index] < now) computeFiringWindows(i, lane);
+
+            // Only the part of the windows between now and the invariant deadline is usable
+            const double deadline = _deadline[lane];
+            bool empty = _lower[index] == inf || _lower[index] > deadline;
+            double lower = empty ? inf : std::max(_lower[index], now);
+            double upper = empty ? inf : std::min(_upper[index], deadline);
+            bool enabled = !empty && lower <= now;
+            double& date = _dates[index];
+            if(initial) {
+                if(enabled) date = now + sample(i, lane);
+            } else {
+                bool newlyEnabled = enabled && (date == inf);
+                bool reachedUpper = enabled && !newlyEnabled && upper <= now && date > now;
+                if(!enabled || reachedUpper) {
+                    date = inf;
+                } else if(newlyEnabled) {
+                    double sampled = sample(i, lane);
+                    if(upper > now || sampled == 0) {
+                        date = now + sampled;
+                    }
+                }
+            }
+
+            const double second = _nextLower[index];
+            bool secondUsable = second != inf && second <= deadline;
+            bool single = !empty && !secondUsable;
+            bool live = !(empty || (single && upper <= now && date > now));
+            if(live != (bool) _live[index]) {
+                _live[index] = live;
+                if(live) _liveCount[lane]++;
+                else _liveCount[lane]--;
+            }
+
+            double boundary = inf;
+            if(!empty && lower <= upper) {
+                if(lower > now) boundary = lower;
+                else if(upper > now) boundary = upper;
+                else if(secondUsable) boundary = second;
+            }
+            _keys[index] = std::min(date, boundary);
+        }
+
+        size_t SMCBatchRunGenerator::chooseWeightedWinner(size_t lane) {
+            LaneEngine engine { *this, lane };
+            double total_weight = 0.0f;
+            _infiniteWinners.clear();
+            for(auto& candidate : _winners) {
+                double priority = _tapn.getTransitions()[candidate]->getWeight();
+                if(priority == std::numeric_limits<double>::infinity()) {
+                    _infiniteWinners.push_back(candidate);
+                } else {
+                    total_weight += priority;
+                }
+            }
+            if(!_infiniteWinners.empty()) {
+                int winner_index = std::uniform_int_distribution<>(0, _infiniteWinners.size() - 1)(engine);
+                return _infiniteWinners[winner_index];
+            }
+            if(total_weight == 0) {
+                int winner_index = std::uniform_int_distribution<>(0, _winners.size() - 1)(engine);
+                return _winners[winner_index];
+            }
+            double winning_weight = std::uniform_real_distribution<>(0.0, total_weight)(engine);
+            for(auto& candidate : _winners) {
+                winning_weight -= _tapn.getTransitions()[candidate]->getWeight();
+                if(winning_weight <= 0) {
+                    return candidate;
+                }
+            }
+            return _winners[0];
+        }
+
+        void SMCBatchRunGenerator::transitionFiringDates(TimedTransition* transi, size_t lane, std::vector<interval<double>>& firingDates) {
+            firingDates.assign(1, interval<double>(0, std::numeric_limits<double>::infinity()));
+            for(InhibitorArc* inhib : transi->getInhibitorArcs()) {
+                if(numberOfTokensInPlace(inhib->getInputPlace().getIndex(), lane) >= inhib->getWeight()) {
+                    firingDates.clear();
+                    return;
+                }
+            }
+            for(TimedInputArc* arc : transi->getPreset()) {
+                size_t place = arc->getInputPlace().getIndex();
+                arcFiringDates(arc->getInterval(), arc->getWeight(), place, lane, _arcDates);
+                Util::setIntersection<double>(firingDates, _arcDates, _intersection);
+                firingDates.swap(_intersection);
+                if(firingDates.empty()) return;
+            }
+            for(TransportArc* arc : transi->getTransportArcs()) {
+                TimeInvariant targetInvariant = arc->getDestination().getInvariant();
+                TimeInterval arcInterval = arc->getInterval();
+                if(targetInvariant.getBound() < arcInterval.getUpperBound()) {
+                    arcInterval.setUpperBound(targetInvariant.getBound(), targetInvariant.isBoundStrict());
+                }
+                arcFiringDates(arcInterval, arc->getWeight(), arc->getSource().getIndex(), lane, _arcDates);
+                Util::setIntersection<double>(firingDates, _arcDates, _intersection);
+                firingDates.swap(_intersection);
+                if(firingDates.empty()) return;
+            }
+        }
+
+        void SMCBatchRunGenerator::arcFiringDates(const TimeInterval& time_interval, uint32_t weight, size_t place, size_t lane, std::vector<interval<double>>& firingDates) {
+            firingDates.clear();
+            const uint32_t n_tokens = _tokens[place * _lanes + lane];
+            if(weight == 0 || n_tokens < weight) return;
+            interval<double> arcInterval(time_interval.getLowerBound(), time_interval.getUpperBound());
+            const double* ages = _ages[place].data() + lane;
+            // Windows of weight consecutive tokens, from the oldest ones; windows with the same oldest and youngest
+            // token ages give the same dates.
+            double lastOldest = std::numeric_limits<double>::quiet_NaN();
+            double lastYoungest = std::numeric_limits<double>::quiet_NaN();
+            for(size_t s = 0 ; s + weight <= n_tokens ; s++) {
+                double oldestAge = ages[s * _lanes];
+                double youngestAge = ages[(s + weight - 1) * _lanes];
+                if(oldestAge == lastOldest && youngestAge == lastYoungest) continue;
+                lastOldest = oldestAge;
+                lastYoungest = youngestAge;
+                interval<double> youngest = arcInterval;
+                youngest.delta(-youngestAge);
+                interval<double> oldest = arcInterval;
+                oldest.delta(-oldestAge);
+                interval<double> tokenSetInterval = Util::intersect(
+                        interval<double>(_clock[lane], std::numeric_limits<double>::infinity()), Util::intersect(youngest, oldest));
+                if(!tokenSetInterval.empty()) {
+                    Util::setAdd(firingDates, tokenSetInterval);
+                }
+            }
+        }
+
+        double SMCBatchRunGenerator::invariantDeadline(size_t lane) const {
+            double deadline = std::numeric_limits<double>::infinity();
+            for(size_t p = 0 ; p < _ages.size() ; p++) {
+                if(_tokens[p * _lanes + lane] == 0) continue;
+                deadline = std::min(deadline, ((double) _tapn.getPlace(p).getInvariant().getBound()) - _ages[p][lane]);
+            }
+            return deadline;
+        }
+
+        void SMCBatchRunGenerator::fire(TimedTransition* transi, size_t lane) {
+            const SMC::FiringMode mode = transi->getFiringMode();
+            for(auto &input : transi->getPreset()) {
+                removeTokens(input->getInputPlace().getIndex(), lane, input->getInterval(), input->getWeight(), mode);
+            }
+
+            _toCreate.clear();
+            for(auto &transport : transi->getTransportArcs()) {
+                int destInv = transport->getDestination().getInvariant().getBound();
+                TimeInterval interval = transport->getInterval();
+                if(destInv < interval.getUpperBound()) interval.setUpperBound(destInv, false);
+                _consumed.clear();
+                removeTokens(transport->getSource().getIndex(), lane, interval, transport->getWeight(), mode, &_consumed);
+                for(double age : _consumed) {
+                    _toCreate.emplace_back(transport->getDestination().getIndex(), age);
+                }
+            }
+
+            for(auto* output : transi->getPostset()) {
+                for(uint32_t w = 0 ; w < output->getWeight() ; w++) {
+                    addToken(output->getOutputPlace().getIndex(), lane, -_clock[lane]); // age 0
+                }
+            }
+            for(auto& [place, age] : _toCreate) {
+                addToken(place, lane, age);
+            }
+        }
+
+        void SMCBatchRunGenerator::removeTokens(size_t place, size_t lane, const TimeInterval& interval, int weight, SMC::FiringMode mode, std::vector<double>* removed) {
+            if(mode == SMC::Random) {
+                removeRandom(place, lane, interval, weight, removed);
+                return;
+            }
+            const double now = _clock[lane];
+            const double* ages = _ages[place].data() + lane;
+            const uint32_t& n_tokens = _tokens[place * _lanes + lane];
+            int remaining = weight;
+            if(mode == SMC::Youngest) {
+                for(size_t s = n_tokens ; s > 0 && remaining > 0 ; s--) {
+                    double age = ages[(s - 1) * _lanes];
+                    if(!SMCRunGenerator::consumable(interval, age, now)) continue;
+                    if(removed != nullptr) removed->push_back(age);
+                    removeSlot(place, lane, s - 1);
+                    remaining--;
+                }
+            } else {
+                size_t s = 0;
+                while(s < n_tokens && remaining > 0) {
+                    double age = ages[s * _lanes];
+                    if(!SMCRunGenerator::consumable(interval, age, now)) {
+                        s++;
+                        continue;
+                    }
+                    if(removed != nullptr) removed->push_back(age);
+                    removeSlot(place, lane, s);
+                    remaining--;
+                }
+            }
+            assert(remaining == 0);
+        }
+
+        void SMCBatchRunGenerator::removeRandom(size_t place, size_t lane, const TimeInterval& interval, int weight, std::vector<double>* removed) {
+            // Tokens are drawn among the distinct ages as in SMCRunGenerator, so the lane's tokens are grouped the same way
+            double* ages = _ages[place].data() + lane;
+            uint32_t& n_tokens = _tokens[place * _lanes + lane];
+            _packets.clear();
+            for(size_t s = n_tokens ; s > 0 ; s--) {
+                double age = ages[(s - 1) * _lanes];
+                if(!_packets.empty() && _packets.back().getAge() == age) _packets.back().add(1);
+                else _packets.emplace_back(age, 1);
+            }
+
+            LaneEngine engine { *this, lane };
+            const double now = _clock[lane];
+            int remaining = weight;
+            std::uniform_int_distribution<> randomTokenIndex(0, _packets.size() - 1);
+            size_t tok_index = randomTokenIndex(engine);
+            size_t tested = 0;
+            while(remaining > 0 && tested < _packets.size()) {
+                RealToken& token = _packets[tok_index];
+                if(SMCRunGenerator::consumable(interval, token.getAge(), now)) {
+                    if(removed != nullptr) removed->push_back(token.getAge());
+                    remaining--;
+                    token.remove(1);
+                    if(token.getCount() == 0) {
+                        _packets.erase(_packets.begin() + tok_index);
+                        randomTokenIndex = std::uniform_int_distribution<>(0, _packets.size() - 1);
+                    }
+                    if(remaining > 0) {
+                        tok_index = randomTokenIndex(engine);
+                        tested = 0;
+                    }
+                } else {
+                    tok_index = (tok_index + 1) % _packets.size();
+                    tested++;
+                }
+            }
+            assert(remaining == 0);
+
+            n_tokens = 0;
+            for(auto token = _packets.rbegin() ; token != _packets.rend() ; token++) {
+                for(int c = 0 ; c < token->getCount() ; c++) {
+                    ages[n_tokens++ * _lanes] = token->getAge();
+                }
+            }
+        }
+
+        void SMCBatchRunGenerator::removeSlot(size_t place, size_t lane, size_t slot) {
+            double* ages = _ages[place].data() + lane;
+            uint32_t& n_tokens = _tokens[place * _lanes + lane];
+            for(size_t s = slot ; s + 1 < n_tokens ; s++) {
+                ages[s * _lanes] = ages[(s + 1) * _lanes];
+            }
+            n_tokens--;
+        }
+
+        void SMCBatchRunGenerator::addToken(size_t place, size_t lane, double age) {
+            uint32_t& n_tokens = _tokens[place * _lanes + lane];
+            reserveSlots(place, n_tokens + 1);
+            double* ages = _ages[place].data() + lane;
+            size_t s = n_tokens;
+            while(s > 0 && ages[(s - 1) * _lanes] < age) {
+                ages[s * _lanes] = ages[(s - 1) * _lanes];
+                s--;
+            }
+            ages[s * _lanes] = age;
+            n_tokens++;
+        }
+
+    }
+}
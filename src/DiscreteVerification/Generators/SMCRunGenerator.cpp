@@ -8,7 +8,6 @@
 #include "DiscreteVerification/Generators/SMCRunGenerator.h"
 
 #include <numeric>
-#include <deque>
 #include <random>
 #include <algorithm>
 
@@ -17,56 +16,94 @@ namespace VerifyTAPN {
 
         using Util::interval;
 
+        void SMCRunGenerator::buildDependencies() {
+            computeDependencies(_tapn, _affectedBy, _touchesInvariant);
+            _events.resize(_tapn.getTransitions().size());
+            _refreshed.assign(_tapn.getTransitions().size(), 0);
+        }
+
+        void SMCRunGenerator::computeDependencies(TimedArcPetriNet& tapn, std::vector<std::vector<uint32_t>>& affectedBy, std::vector<bool>& touchesInvariant) {
+            const auto& transitions = tapn.getTransitions();
+            std::vector<std::vector<uint32_t>> dependents(tapn.getNumberOfPlaces());
+            for(auto* transi : transitions) {
+                for(auto* arc : transi->getPreset()) {
+                    dependents[arc->getInputPlace().getIndex()].push_back(transi->getIndex());
+                }
+                for(auto* arc : transi->getInhibitorArcs()) {
+                    dependents[arc->getInputPlace().getIndex()].push_back(transi->getIndex());
+                }
+                for(auto* arc : transi->getTransportArcs()) {
+                    dependents[arc->getSource().getIndex()].push_back(transi->getIndex());
+                }
+            }
+            affectedBy.assign(transitions.size(), std::vector<uint32_t>());
+            touchesInvariant.assign(transitions.size(), false);
+            for(auto* transi : transitions) {
+                auto& affected = affectedBy[transi->getIndex()];
+                auto addPlace = [&](const TimedPlace& place) {
+                    const auto& deps = dependents[place.getIndex()];
+                    affected.insert(affected.end(), deps.begin(), deps.end());
+                    if(place.getInvariant().getBound() != std::numeric_limits<int>::max()) {
+                        touchesInvariant[transi->getIndex()] = true;
+                    }
+                };
+                for(auto* arc : transi->getPreset()) addPlace(arc->getInputPlace());
+                for(auto* arc : transi->getTransportArcs()) {
+                    addPlace(arc->getSource());
+                    addPlace(arc->getDestination());
+                }
+                for(auto* arc : transi->getPostset()) addPlace(arc->getOutputPlace());
+                std::sort(affected.begin(), affected.end());
+                affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+            }
+        }
+
         void SMCRunGenerator::prepare(RealMarking *parent) {
-            _origin = new RealMarking(*parent);
+            // Runs are dated from 0 on the marking clock
+            assert(parent->getClock() == 0);
+            // parent may be the live marking of this generator, so copy it before releasing the previous run
+            RealMarking* origin = new RealMarking(*parent);
+            delete _origin;
+            delete _parent;
+            _origin = origin;
             _parent = new RealMarking(*_origin);
-            RealPlaceList& places = _origin->getPlaceList();
-            std::vector<bool> transitionSeen(_defaultTransitionIntervals.size(), false);
-            double originMaxDelay = _origin->availableDelay();
-            std::vector<interval<double>> invInterval = { interval<double>(0, originMaxDelay) };
+            _totalTime = 0;
+            _transitionIntervals.resize(_defaultTransitionIntervals.size());
             for(auto transi : _tapn.getTransitions()) {
-                if(transi->getPresetSize() == 0 && transi->getNumberOfInhibitorArcs() == 0) {
-                    _defaultTransitionIntervals[transi->getIndex()] = invInterval;
-                } else {
-                    std::vector<interval<double>> firingDates = transitionFiringDates(transi);
-                    _defaultTransitionIntervals[transi->getIndex()] = Util::setIntersection(firingDates, invInterval);
-                }
+                computeFiringWindows(transi->getIndex());
+                _defaultTransitionIntervals[transi->getIndex()] = _transitionIntervals[transi->getIndex()];
             }
             reset();
         }
 
         void SMCRunGenerator::reset() {
-            if(_trace.size() > 0) {
-                for(RealMarking* marking : _trace) {
-                    if(marking != nullptr) delete marking;
-                }
-                _trace.clear();
+            if(_parent != nullptr) {
+                *_parent = *_origin;
+                _parent->setPreviousDelay(0);
+                _parent->setGeneratedBy(nullptr);
+            } else {
+                _parent = new RealMarking(*_origin);
             }
-            else if(_parent != nullptr) delete _parent;
-            _parent = new RealMarking(*_origin);
             if(recordTrace) {
-                _trace = { new RealMarking(*_origin), _parent };
+                _trace.emplace(*_origin);
             }
             _transitionIntervals = _defaultTransitionIntervals;
             _maximal = false;
             _totalTime = 0;
             _totalSteps = 0;
-            _dates_sampled = std::vector<double>(_transitionIntervals.size(), std::numeric_limits<double>::infinity());
-            bool deadlocked = true;
-            for(int i = 0 ; i < _dates_sampled.size() ; i++) {
-                auto* intervals = &_transitionIntervals[i];
-                if(!intervals->empty() && intervals->front().lower() == 0) {
-                    const Distribution& distrib = _tapn.getTransitions()[i]->getDistribution();
-                    _dates_sampled[i] = distrib.sample(_rng, _numericPrecision);
-                }
-                deadlocked &=   _transitionIntervals[i].empty() || 
-                                (
-                                    _transitionIntervals[i].size() == 1 &&
-                                    _transitionIntervals[i].front().upper() == 0 &&
-                                    _dates_sampled[i] > 0
-                                );
+            _deadline = _origin->availableDelay();
+            _dates_sampled.assign(_transitionIntervals.size(), std::numeric_limits<double>::infinity());
+            _live.assign(_transitionIntervals.size(), false);
+            _liveCount = 0;
+            _events.clear();
+            for(size_t i = 0 ; i < _transitionIntervals.size() ; i++) {
+                refreshTransition(i, true);
             }
-            _parent->setDeadlocked(deadlocked);
+            _parent->setDeadlocked(_liveCount == 0);
+        }
+
+        void SMCRunGenerator::setSeed(uint64_t seed, uint32_t stream) {
+            seedEngine(_rng, seed, stream);
         }
 
         SMCRunGenerator SMCRunGenerator::copy() const
@@ -80,43 +117,107 @@ namespace VerifyTAPN {
             return clone;
         }
 
-        void SMCRunGenerator::refreshTransitionsIntervals()
+        SMCRunState SMCRunGenerator::saveState() const
         {
-            double max_delay = _parent->availableDelay();
-            std::vector<interval<double>> invInterval = { interval<double>(0, max_delay) };
-            bool deadlocked = true;
-            for(auto transi : _tapn.getTransitions()) {
-                int i = transi->getIndex();
-                if(transi->getPresetSize() == 0 && transi->getNumberOfInhibitorArcs() == 0) {
-                    _transitionIntervals[i] = invInterval;
-                } else {
-                    std::vector<interval<double>> firingDates = transitionFiringDates(transi);
-                    _transitionIntervals[i] = Util::setIntersection(firingDates, invInterval);
+            assert(!recordTrace);
+            SMCRunState state(*_parent);
+            state.transitionIntervals = _transitionIntervals;
+            state.datesSampled = _dates_sampled;
+            state.deadline = _deadline;
+            state.events = _events;
+            state.live = _live;
+            state.liveCount = _liveCount;
+            state.maximal = _maximal;
+            state.totalTime = _totalTime;
+            state.totalSteps = _totalSteps;
+            return state;
+        }
+
+        void SMCRunGenerator::restoreState(const SMCRunState& state)
+        {
+            assert(!recordTrace && _parent != nullptr);
+            *_parent = state.marking;
+            _transitionIntervals = state.transitionIntervals;
+            _dates_sampled = state.datesSampled;
+            _deadline = state.deadline;
+            _events = state.events;
+            _live = state.live;
+            _liveCount = state.liveCount;
+            _maximal = state.maximal;
+            _totalTime = state.totalTime;
+            _totalSteps = state.totalSteps;
+        }
+
+        void SMCRunGenerator::computeFiringWindows(size_t i) {
+            TimedTransition* transi = _tapn.getTransitions()[i];
+            auto& windows = _transitionIntervals[i];
+            if(transi->getPresetSize() == 0 && transi->getNumberOfInhibitorArcs() == 0) {
+                windows.assign(1, interval<double>(_totalTime, std::numeric_limits<double>::infinity()));
+            } else {
+                transitionFiringDates(transi, windows);
+            }
+        }
+
+        void SMCRunGenerator::refreshTransition(size_t i, bool initial)
+        {
+            const double now = _totalTime;
+            auto& windows = _transitionIntervals[i];
+            size_t expired = 0;
+            while(expired < windows.size() && windows[expired].upper() < now) expired++;
+            if(expired > 0) windows.erase(windows.begin(), windows.begin() + expired);
+
+            // Only the part of the windows between now and the invariant deadline is usable
+            bool empty = windows.empty() || windows.front().lower() > _deadline;
+            double lower = empty ? std::numeric_limits<double>::infinity() : std::max(windows.front().lower(), now);
+            double upper = empty ? std::numeric_limits<double>::infinity() : std::min(windows.front().upper(), _deadline);
+            bool enabled = !empty && lower <= now;
+            double& date = _dates_sampled[i];
+            if(initial) {
+                if(enabled) {
+                    const Distribution& distrib = _tapn.getTransitions()[i]->getDistribution();
+                    date = now + distrib.sample(_rng, _numericPrecision);
                 }
-                bool enabled = (!_transitionIntervals[i].empty()) && (_transitionIntervals[i].front().lower() == 0);
-                bool newlyEnabled = enabled && (_dates_sampled[i] == std::numeric_limits<double>::infinity());
-                bool reachedUpper = enabled && !newlyEnabled && (_transitionIntervals[i].front().upper() == 0) && _dates_sampled[i] > 0;
+            } else {
+                bool newlyEnabled = enabled && (date == std::numeric_limits<double>::infinity());
+                bool reachedUpper = enabled && !newlyEnabled && upper <= now && date > now;
                 if(!enabled || reachedUpper) {
-                    _dates_sampled[i] = std::numeric_limits<double>::infinity();
+                    date = std::numeric_limits<double>::infinity();
                 } else if(newlyEnabled) {
                     const Distribution& distrib = _tapn.getTransitions()[i]->getDistribution();
-                    double date = distrib.sample(_rng, _numericPrecision);
-                    if(_transitionIntervals[i].front().upper() > 0 || date == 0) {
-                        _dates_sampled[i] = date;
+                    double sampled = distrib.sample(_rng, _numericPrecision);
+                    if(upper > now || sampled == 0) {
+                        date = now + sampled;
                     }
                 }
-                deadlocked &=   _transitionIntervals[i].empty() || 
-                                (
-                                    _transitionIntervals[i].size() == 1 &&
-                                    _transitionIntervals[i].front().upper() == 0 &&
-                                    _dates_sampled[i] > 0
-                                );
             }
-            _parent->setDeadlocked(deadlocked);
+
+            bool single = !empty && (windows.size() == 1 || windows[1].lower() > _deadline);
+            bool live = !(empty || (single && upper <= now && date > now));
+            if(live != _live[i]) {
+                _live[i] = live;
+                if(live) _liveCount++;
+                else _liveCount--;
+            }
+
+            double boundary = std::numeric_limits<double>::infinity();
+            for(auto& window : windows) {
+                double low = std::max(window.lower(), now);
+                double high = std::min(window.upper(), _deadline);
+                if(low > high) break;
+                if(low > now) {
+                    boundary = low;
+                    break;
+                }
+                if(high > now) {
+                    boundary = high;
+                    break;
+                }
+            }
+            _events.update(i, std::min(date, boundary));
         }
 
         void SMCRunGenerator::disableTransitions(RealMarking* marking) {
-            for(int i = 0 ; i < _dates_sampled.size() ; i++) {
+            for(size_t i = 0 ; i < _dates_sampled.size() ; i++) {
                 double date = _dates_sampled[i];
                 if(date == std::numeric_limits<double>::infinity()) continue;
                 TimedTransition* transition = _tapn.getTransitions()[i];
@@ -134,78 +235,92 @@ namespace VerifyTAPN {
                 return nullptr;
             }
 
-            _parent->deltaAge(delay);
-            _totalTime += delay;
+            // The clock jumps to the event date itself, so windows opening or closing at that date compare equal to now.
+            // The marking clock is set to the same date, so token ages and windows share one time base.
+            _totalTime = _events.topKey();
+            _parent->setClock(_totalTime);
 
             _parent->setPreviousDelay(delay + _parent->getPreviousDelay());
-        
+            if(recordTrace && transi == nullptr) {
+                _trace->steps.push_back({ _totalTime, -1, false });
+            }
+
+            if(++_refreshStamp == 0) {
+                std::fill(_refreshed.begin(), _refreshed.end(), 0);
+                _refreshStamp = 1;
+            }
+            bool refreshAll = false;
             if(transi != nullptr) {
                 _totalSteps++;
                 _transitionsStatistics[transi->getIndex()]++;
                 _dates_sampled[transi->getIndex()] = std::numeric_limits<double>::infinity();
-                auto child = fire(transi);
-                child->setGeneratedBy(transi);
                 if(recordTrace) {
-                    _trace.push_back(child);
-                    _parent = new RealMarking(*child);
-                    _trace.push_back(_parent);
+                    _trace->steps.push_back({ _totalTime, (int32_t) transi->getIndex(), _parent->canDeadlock(_tapn, 0) });
+                    fire(transi, *_parent, &_trace->consumed);
                 } else {
-                    delete _parent;
-                    _parent = child;
+                    fire(transi, *_parent);
+                }
+                _parent->setPreviousDelay(0);
+                _parent->setGeneratedBy(transi);
+                if(_touchesInvariant[transi->getIndex()]) {
+                    double deadline = std::max(_totalTime, _parent->getInvariantDeadline());
+                    refreshAll = deadline != _deadline;
+                    _deadline = deadline;
+                }
+                for(auto i : _affectedBy[transi->getIndex()]) {
+                    computeFiringWindows(i);
+                    if(!refreshAll) {
+                        _refreshed[i] = _refreshStamp;
+                        refreshTransition(i);
+                    }
                 }
             }
 
-            for(int i = 0 ; i < _transitionIntervals.size() ; i++) {
-                double date = _dates_sampled[i];
-                _dates_sampled[i] = (date == std::numeric_limits<double>::infinity()) ?
-                    std::numeric_limits<double>::infinity() : date - delay;
+            if(refreshAll) {
+                for(size_t i = 0 ; i < _transitionIntervals.size() ; i++) {
+                    refreshTransition(i);
+                }
+            } else {
+                for(auto i : _due) {
+                    if(_refreshed[i] == _refreshStamp) continue;
+                    _refreshed[i] = _refreshStamp;
+                    refreshTransition(i);
+                }
             }
-
-            refreshTransitionsIntervals();
+            _parent->setDeadlocked(_liveCount == 0);
 
             return _parent;
         }
 
         std::pair<TimedTransition*, double> SMCRunGenerator::getWinnerTransitionAndDelay() {
-            std::vector<size_t> winner_indexs;
-            double date_min = std::numeric_limits<double>::infinity();
-            for(int i = 0 ; i < _transitionIntervals.size() ; i++) {
-                auto* intervals = &_transitionIntervals[i];
-                if(intervals->empty()) continue;
-                double date = std::numeric_limits<double>::infinity();
-                for(auto& interv : *intervals) {
-                    if(interv.lower() > 0) {
-                        date = interv.lower();
-                        break;
-                    }
-                    if(interv.upper() > 0) {
-                        date = interv.upper();
-                        break;
-                    }
-                }
-                date = std::min(_dates_sampled[i], date);
-                if(date < date_min) {
-                    date_min = date;
-                    winner_indexs.clear();
-                }
+            double date_min = _events.topKey();
+            _due.clear();
+            _winners.clear();
+            if(date_min == std::numeric_limits<double>::infinity()) {
+                return std::make_pair(nullptr, date_min);
+            }
+            _events.forEachMinimum([&](size_t i) {
+                _due.push_back(i);
                 if(_dates_sampled[i] == date_min) {
-                    winner_indexs.push_back(i);
+                    _winners.push_back(i);
                 }
-            }
+            });
+            std::sort(_winners.begin(), _winners.end());
             TimedTransition *winner;
-            if(winner_indexs.empty()) { 
+            if(_winners.empty()) { 
                 winner = nullptr;
-            } else if(winner_indexs.size() == 1) {
-                winner = _tapn.getTransitions()[winner_indexs[0]];
+            } else if(_winners.size() == 1) {
+                winner = _tapn.getTransitions()[_winners[0]];
             } else {
-                winner = chooseWeightedWinner(winner_indexs);
+                winner = chooseWeightedWinner(_winners);
             }
-            return std::make_pair(winner, date_min);
+            return std::make_pair(winner, date_min - _totalTime);
         }
 
         TimedTransition* SMCRunGenerator::chooseWeightedWinner(const std::vector<size_t>& winner_indexs) {
             double total_weight = 0.0f;
-            std::vector<size_t> infty_weights;
+            std::vector<size_t>& infty_weights = _infiniteWinners;
+            infty_weights.clear();
             for(auto& candidate : winner_indexs) {
                 double priority = _tapn.getTransitions()[candidate]->getWeight();
                 if(priority == std::numeric_limits<double>::infinity()) {
@@ -233,75 +348,104 @@ namespace VerifyTAPN {
             return _tapn.getTransitions()[winner_indexs[0]];
         }
 
-        std::vector<interval<double>> SMCRunGenerator::transitionFiringDates(TimedTransition* transi) {
-            RealPlaceList &places = _parent->getPlaceList();
-            std::vector<interval<double>> firingInterval = { interval<double>(0, std::numeric_limits<double>::infinity()) };
-            std::vector<interval<double>> disabled;
+        void SMCRunGenerator::transitionFiringDates(TimedTransition* transi, std::vector<interval<double>>& firingDates) {
+            firingDates.assign(1, interval<double>(0, std::numeric_limits<double>::infinity()));
             for(InhibitorArc* inhib : transi->getInhibitorArcs()) {
                 if(_parent->numberOfTokensInPlace(inhib->getInputPlace().getIndex()) >= inhib->getWeight()) {
-                    return disabled;
-                } 
+                    firingDates.clear();
+                    return;
+                }
             }
             for(TimedInputArc* arc : transi->getPreset()) {
                 auto &place = _parent->getPlaceList()[arc->getInputPlace().getIndex()];
-                if(place.isEmpty()) return disabled;
-                firingInterval = Util::setIntersection<double>(firingInterval, arcFiringDates(arc->getInterval(), arc->getWeight(), place.tokens));
-                if(firingInterval.empty()) return firingInterval;
+                if(place.isEmpty()) {
+                    firingDates.clear();
+                    return;
+                }
+                arcFiringDates(arc->getInterval(), arc->getWeight(), place.tokens, _totalTime, _arcDates);
+                Util::setIntersection<double>(firingDates, _arcDates, _intersection);
+                firingDates.swap(_intersection);
+                if(firingDates.empty()) return;
             }
             for(TransportArc* arc : transi->getTransportArcs()) {
                 auto &place = _parent->getPlaceList()[arc->getSource().getIndex()];
-                if(place.isEmpty()) return disabled;
+                if(place.isEmpty()) {
+                    firingDates.clear();
+                    return;
+                }
                 TimeInvariant targetInvariant = arc->getDestination().getInvariant();
                 TimeInterval arcInterval = arc->getInterval();
                 if(targetInvariant.getBound() < arcInterval.getUpperBound()) {
                     arcInterval.setUpperBound(targetInvariant.getBound(), targetInvariant.isBoundStrict());
-                } 
-                firingInterval = Util::setIntersection<double>(firingInterval, arcFiringDates(arcInterval, arc->getWeight(), place.tokens));
-                if(firingInterval.empty()) return firingInterval;
+                }
+                arcFiringDates(arcInterval, arc->getWeight(), place.tokens, _totalTime, _arcDates);
+                Util::setIntersection<double>(firingDates, _arcDates, _intersection);
+                firingDates.swap(_intersection);
+                if(firingDates.empty()) return;
             }
-            return firingInterval;
         }
 
-        std::vector<interval<double>> SMCRunGenerator::arcFiringDates(TimeInterval time_interval, uint32_t weight, RealTokenList& tokens) {
+        void SMCRunGenerator::arcFiringDates(TimeInterval time_interval, uint32_t weight, RealTokenList& tokens, double now, std::vector<interval<double>>& firingDates) {
             // We assume tokens is SORTED !
+            firingDates.clear();
             Util::interval<double> arcInterval(time_interval.getLowerBound(), time_interval.getUpperBound());
             size_t total_tokens = 0;
             for(auto &t : tokens) {
                 total_tokens += t.getCount();
             }
-            if(total_tokens < weight) return std::vector<interval<double>>();
-            std::vector<interval<double>> firingDates;
-            std::deque<double> selected;
-            for(auto& tokenPckt : tokens) {
-                for(int i = 0 ; i < tokenPckt.getCount() ; i++) {
-                    selected.push_back(tokenPckt.getAge());
-                    if(selected.size() > weight) {
-                        selected.pop_front();
-                    }
-                    if(selected.size() == weight) {
-                        interval<double> tokenSetInterval = interval<double>(0, std::numeric_limits<double>::infinity());
-                        for(auto age : selected) {
-                            interval<double> shifted = arcInterval;
-                            shifted.delta(-age);
-                            tokenSetInterval = Util::intersect(tokenSetInterval, shifted);
-                        }
-                        Util::setAdd(firingDates, tokenSetInterval);
-                    }
+            if(weight == 0 || total_tokens < weight) return;
+            // Slide a window over weight consecutive tokens. The dates at which a window can be consumed only depend
+            // on its youngest and oldest token, so we jump directly to the next window changing one of them.
+            auto count = [&](size_t i) { return (size_t) tokens[i].getCount(); };
+            size_t front = 0, back = 0;
+            size_t frontSkipped = 0; // tokens of tokens[front] before the window
+            size_t backTaken = weight; // tokens of tokens[back] in the window
+            while(count(back) < backTaken) {
+                backTaken -= count(back);
+                back++;
+            }
+            while(true) {
+                interval<double> youngest = arcInterval;
+                youngest.delta(-tokens[front].getAge());
+                interval<double> oldest = arcInterval;
+                oldest.delta(-tokens[back].getAge());
+                interval<double> tokenSetInterval = Util::intersect(
+                        interval<double>(now, std::numeric_limits<double>::infinity()), Util::intersect(youngest, oldest));
+                if(!tokenSetInterval.empty()) {
+                    Util::setAdd(firingDates, tokenSetInterval);
+                }
+                size_t frontLeft = count(front) - frontSkipped;
+                size_t backLeft = count(back) - backTaken;
+                size_t step;
+                if(back + 1 < tokens.size()) {
+                    step = std::min(frontLeft, backLeft + 1);
+                } else if(frontLeft <= backLeft) {
+                    step = frontLeft;
+                } else {
+                    break;
+                }
+                frontSkipped += step;
+                if(frontSkipped == count(front)) {
+                    front++;
+                    frontSkipped = 0;
+                }
+                backTaken += step;
+                if(backTaken > count(back)) {
+                    backTaken -= count(back);
+                    back++;
                 }
             }
-            return firingDates;
         }
-        
-        std::vector<RealToken> SMCRunGenerator::removeRandom(RealTokenList& tokenList, const TimeInterval& interval, const int weight) {
-            std::vector<RealToken> res;
+
+        void SMCRunGenerator::removeRandom(RealTokenList& tokenList, double clock, const TimeInterval& interval, const int weight, std::vector<RealToken>* removed) {
             int remaining = weight;
             std::uniform_int_distribution<> randomTokenIndex(0, tokenList.size() - 1);
             size_t tok_index = randomTokenIndex(_rng);
             size_t tested = 0;
             while(remaining > 0 && tested < tokenList.size()) {
                 RealToken& token = tokenList[tok_index];
-                if(interval.contains(token.getAge())) {
-                    res.push_back(RealToken(token.getAge(), 1));
+                if(consumable(interval, token.getAge(), clock)) {
+                    if(removed != nullptr) removed->push_back(RealToken(token.getAge(), 1));
                     remaining--;
                     tokenList[tok_index].remove(1);
                     if(tokenList[tok_index].getCount() == 0) {
@@ -318,126 +462,134 @@ namespace VerifyTAPN {
                 }
             }
             assert(remaining == 0);
-            return res;
         }
 
-        std::vector<RealToken> SMCRunGenerator::removeYoungest(RealTokenList& tokenList, const TimeInterval& interval, const int weight) {
-            std::vector<RealToken> res;
+        void SMCRunGenerator::removeYoungest(RealTokenList& tokenList, double clock, const TimeInterval& interval, const int weight, std::vector<RealToken>* removed) {
             int remaining = weight;
             auto iter = tokenList.begin();
             while(iter != tokenList.end()) {
                 double age = iter->getAge();
-                if(!interval.contains(age)) {
+                if(!consumable(interval, age, clock)) {
                     iter++;
                     continue;
                 }
                 int count = iter->getCount();
                 if(count >= remaining) {
-                    res.push_back(RealToken(age, remaining));
+                    if(removed != nullptr) removed->push_back(RealToken(age, remaining));
                     iter->remove(remaining);
                     if(iter->getCount() == 0) tokenList.erase(iter);
                     remaining = 0;
                     break;
                 } else {
-                    res.push_back(RealToken(age, count));
+                    if(removed != nullptr) removed->push_back(RealToken(age, count));
                     remaining -= count;
                     iter = tokenList.erase(iter);
                 }
             }
             assert(remaining == 0);
-            return res;
         }
 
-        std::vector<RealToken> SMCRunGenerator::removeOldest(RealTokenList& tokenList, const TimeInterval& interval, const int weight) {
-            std::vector<RealToken> res;
+        void SMCRunGenerator::removeOldest(RealTokenList& tokenList, double clock, const TimeInterval& interval, const int weight, std::vector<RealToken>* removed) {
             int remaining = weight;
             auto iter = tokenList.rbegin();
             while(iter != tokenList.rend()) {
                 double age = iter->getAge();
-                if(!interval.contains(age)) {
+                if(!consumable(interval, age, clock)) {
                     iter++;
                     continue;
                 }
                 int count = iter->getCount();
                 if(count >= remaining) {
-                    res.push_back(RealToken(age, remaining));
+                    if(removed != nullptr) removed->push_back(RealToken(age, remaining));
                     iter->remove(remaining);
                     if(iter->getCount() == 0) tokenList.erase(std::next(iter).base());
                     remaining = 0;
                     break;
                 } else {
-                    res.push_back(RealToken(age, count));
+                    if(removed != nullptr) removed->push_back(RealToken(age, count));
                     remaining -= count;
                     iter = decltype(iter)(tokenList.erase(std::next(iter).base()));
                 }
             }
             assert(remaining == 0);
-            return res;
         }
 
-        RealMarking* SMCRunGenerator::fire(TimedTransition* transi) {
+        void SMCRunGenerator::fire(TimedTransition* transi, RealMarking& marking, std::vector<double>* consumed) {
             if (transi == nullptr) {
                 assert(false);
-                return nullptr;
+                return;
             }
-            auto *child = new RealMarking(*_parent);
-            RealPlaceList &placelist = child->getPlaceList();
+            RealPlaceList &placelist = marking.getPlaceList();
+            const double clock = marking.getClock();
 
             for (auto &input : transi->getPreset()) {
                 RealPlace& place = placelist[input->getInputPlace().getIndex()];
                 RealTokenList& tokenList = place.tokens;
+                std::vector<RealToken>* removed = nullptr;
+                if(consumed != nullptr) {
+                    _consumed.clear();
+                    removed = &_consumed;
+                }
                 switch(transi->getFiringMode()) {
                     case SMC::Random:
-                        removeRandom(tokenList, input->getInterval(), input->getWeight());
+                        removeRandom(tokenList, clock, input->getInterval(), input->getWeight(), removed);
                         break;
                     case SMC::Oldest:
-                        removeOldest(tokenList, input->getInterval(), input->getWeight());
+                        removeOldest(tokenList, clock, input->getInterval(), input->getWeight(), removed);
                         break;
                     case SMC::Youngest:
-                        removeYoungest(tokenList, input->getInterval(), input->getWeight());
+                        removeYoungest(tokenList, clock, input->getInterval(), input->getWeight(), removed);
                         break;
                     default:
-                        removeOldest(tokenList, input->getInterval(), input->getWeight());
+                        removeOldest(tokenList, clock, input->getInterval(), input->getWeight(), removed);
                         break;
                 }
+                if(consumed != nullptr) {
+                    for(RealToken token : _consumed) {
+                        consumed->insert(consumed->end(), token.getCount(), token.getAge());
+                    }
+                }
             }
 
-            std::vector<std::tuple<TimedPlace&, RealToken>> toCreate;
+            _toCreate.clear();
             for (auto &transport : transi->getTransportArcs()) {
                 int destInv = transport->getDestination().getInvariant().getBound();
                 RealPlace& place = placelist[transport->getSource().getIndex()];
                 RealTokenList& tokenList = place.tokens;
-                std::vector<RealToken> consumed;
                 TimeInterval interval = transport->getInterval();
                 if(destInv < interval.getUpperBound()) interval.setUpperBound(destInv, false);
+                _consumed.clear();
                 switch(transi->getFiringMode()) {
                     case SMC::Random:
-                        consumed = removeRandom(tokenList, interval, transport->getWeight());
+                        removeRandom(tokenList, clock, interval, transport->getWeight(), &_consumed);
                         break;
                     case SMC::Oldest:
-                        consumed = removeOldest(tokenList, interval, transport->getWeight());
+                        removeOldest(tokenList, clock, interval, transport->getWeight(), &_consumed);
                         break;
                     case SMC::Youngest:
-                        consumed = removeYoungest(tokenList, interval, transport->getWeight());
+                        removeYoungest(tokenList, clock, interval, transport->getWeight(), &_consumed);
                         break;
                     default:
-                        consumed = removeOldest(tokenList, interval, transport->getWeight());
+                        removeOldest(tokenList, clock, interval, transport->getWeight(), &_consumed);
                         break;
                 }
-                for(RealToken token : consumed) {
-                    toCreate.push_back({transport->getDestination(), token});
+                for(RealToken token : _consumed) {
+                    _toCreate.emplace_back(&transport->getDestination(), token);
+                    if(consumed != nullptr) consumed->insert(consumed->end(), token.getCount(), token.getAge());
                 }
             }
 
+            // The tokens were removed through the token lists
+            marking.tokensChanged();
+
             for (auto* output : transi->getPostset()) {
                 TimedPlace &place = output->getOutputPlace();
-                RealToken token = RealToken(0.0, output->getWeight());
-                child->addTokenInPlace(place, token);
+                RealToken token = RealToken(-clock, output->getWeight()); // age 0
+                marking.addTokenInPlace(place, token);
             }
-            for (auto [dest, token] : toCreate) {
-                child->addTokenInPlace(dest, token);
+            for (auto& [dest, token] : _toCreate) {
+                marking.addTokenInPlace(*dest, token);
             }
-            return child;
         }
 
         bool SMCRunGenerator::reachedEnd() const {
@@ -466,19 +618,16 @@ namespace VerifyTAPN {
             out << std::endl;
         }
 
-        std::stack<RealMarking*> SMCRunGenerator::getTrace() const {
-            std::stack<RealMarking*> trace;
-            for(int i = 0 ; i < _trace.size() ; i++) {
-                RealMarking* marking = _trace[_trace.size() - 1 - i];
-                if(marking == nullptr) trace.push(nullptr);
-                else {
-                    RealMarking* toSave = new RealMarking(*marking);
-                    toSave->setGeneratedBy(marking->getGeneratedBy());
-                    toSave->setPreviousDelay(marking->getPreviousDelay());
-                    toSave->setDeadlocked(marking->canDeadlock(_tapn, 0));
-                    trace.push(toSave);
-                }
+        void SMCRunGenerator::addTransitionStatistics(const std::vector<uint32_t>& statistics) {
+            for(size_t i = 0 ; i < statistics.size() ; i++) {
+                _transitionsStatistics[i] += statistics[i];
             }
+        }
+
+        SMCTrace SMCRunGenerator::getTrace() const {
+            assert(recordTrace && _trace.has_value());
+            SMCTrace trace = *_trace;
+            trace.deadlocked = _parent->canDeadlock(_tapn, 0);
             return trace;
         }
 
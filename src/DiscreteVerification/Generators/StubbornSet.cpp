@@ -23,7 +23,63 @@ namespace VerifyTAPN {
         StubbornSet::StubbornSet(const TimedArcPetriNet& tapn, AST::Query* query)
         : _tapn(tapn), _query(query), _gen_enabled(tapn), _interesting(tapn), 
           _enabled(tapn.getTransitions().size()), _stubborn(tapn.getTransitions().size()) {
-            
+            compute_dependencies();
+        }
+
+        void StubbornSet::compute_dependencies() {
+            for (auto* place : _tapn.getPlaces()) {
+                for (auto* arc : place->getOutputArcs())
+                    _increasing.entries.push_back(arc->getInputTransition().getIndex());
+                for (auto* arc : place->getProdTransportArcs())
+                    _increasing.entries.push_back(arc->getTransition().getIndex());
+                _increasing.close();
+
+                for (auto* arc : place->getInputArcs())
+                    _decreasing.entries.push_back({arc->getOutputTransition().getIndex(), &arc->getInterval()});
+                for (auto* arc : place->getTransportArcs()) {
+                    if (&arc->getSource() == &arc->getDestination()) continue;
+                    _decreasing.entries.push_back({arc->getTransition().getIndex(), &arc->getInterval()});
+                }
+                _decreasing.close();
+
+                for (auto* arc : place->getInhibitorArcs())
+                    _inhibited.entries.push_back(arc->getOutputTransition().getIndex());
+                _inhibited.close();
+            }
+
+            // what firing an enabled transition may disable: transitions consuming from its preset in an
+            // overlapping interval, and transitions inhibited by its postset
+            std::vector<bool> seen(_tapn.getTransitions().size());
+            auto interferes = [&](uint32_t t) {
+                if (!seen[t]) {
+                    seen[t] = true;
+                    _interfering.entries.push_back(t);
+                }
+            };
+            auto consumes = [&](const TimedPlace& place, const TimeInterval& interval) {
+                _consumed.entries.push_back(place.getIndex());
+                for (auto* d = _decreasing.begin(place.getIndex()); d != _decreasing.end(place.getIndex()); ++d)
+                    if (interval.intersects(*d->interval)) interferes(d->transition);
+            };
+            auto produces = [&](const TimedPlace& place) {
+                for (auto* t = _inhibited.begin(place.getIndex()); t != _inhibited.end(place.getIndex()); ++t)
+                    interferes(*t);
+            };
+            for (auto* trans : _tapn.getTransitions()) {
+                size_t first = _interfering.entries.size();
+                for (auto* a : trans->getPreset())
+                    consumes(a->getInputPlace(), a->getInterval());
+                for (auto* a : trans->getPostset())
+                    produces(a->getOutputPlace());
+                for (auto* a : trans->getTransportArcs()) {
+                    consumes(a->getSource(), a->getInterval());
+                    produces(a->getDestination());
+                }
+                for (size_t i = first; i < _interfering.entries.size(); ++i)
+                    seen[_interfering.entries[i]] = false;
+                _consumed.close();
+                _interfering.close();
+            }
         }
 
         const TimedTransition* StubbornSet::pop_next() {
@@ -31,58 +87,35 @@ namespace VerifyTAPN {
             {
                 auto tid = _enabled_set.front();
                 _enabled_set.pop_front();
-                if(!_stubborn[tid]) continue;
+                if(!_stubborn.test(tid)) continue;
                 return _tapn.getTransitions()[tid];
             }
             return nullptr;
         }
 
         void StubbornSet::preset_of(size_t i) {
-            auto place = _tapn.getPlaces()[i];
-            for (auto* arc : place->getOutputArcs()) {
-                auto t = arc->getInputTransition().getIndex();
-                assert(t < _tapn.getTransitions().size());
-                set_stubborn(t);
-            }
-            for (auto* arc : place->getProdTransportArcs()) {
-                auto t = arc->getTransition().getIndex();
-                assert(t < _tapn.getTransitions().size());
-                set_stubborn(t);
-            }
+            for (auto* t = _increasing.begin(i); t != _increasing.end(i); ++t)
+                set_stubborn(*t);
         }
 
-        void StubbornSet::postset_of(size_t i, const TAPN::TimeInterval &interval) {
-            auto place = _tapn.getPlaces()[i];
-            if (!_added_zt) {
-                auto &tl = _parent->getTokenList(place->getIndex());
-                if (!tl.empty()) {
-                    if (place->getInvariant().getBound() == tl.back().getAge())
-                        _added_zt = true;
-                }
-            }
-            for (auto* arc : place->getInputArcs()) {
-                auto t = arc->getOutputTransition().getIndex();
-                assert(t < _tapn.getTransitions().size());
-                if (!interval.intersects(arc->getInterval())) continue;
-                set_stubborn(t);
-            }
+        void StubbornSet::check_zero_time(size_t i) {
+            auto &tl = _parent->getTokenList(i);
+            if (!tl.empty() && _tapn.getPlaces()[i]->getInvariant().getBound() == tl.back().getAge())
+                _added_zt = true;
+        }
 
-            for (auto* arc : place->getTransportArcs()) {
-                if (&arc->getSource() == &arc->getDestination()) continue;
-                auto t = arc->getTransition().getIndex();
-                assert(t < _tapn.getTransitions().size());
-                if (!interval.intersects(arc->getInterval())) continue;
-                set_stubborn(t);
+        void StubbornSet::postset_of(size_t i, const TAPN::TimeInterval &interval) {
+            if (!_added_zt)
+                check_zero_time(i);
+            for (auto* d = _decreasing.begin(i); d != _decreasing.end(i); ++d) {
+                if (!interval.intersects(*d->interval)) continue;
+                set_stubborn(d->transition);
             }
         }
 
         void StubbornSet::inhib_postset_of(size_t i) {
-            auto place = _tapn.getPlaces()[i];
-            for (auto* arc : place->getInhibitorArcs()) {
-                auto t = arc->getOutputTransition().getIndex();
-                assert(t < _tapn.getTransitions().size());
-                set_stubborn(t);
-            }
+            for (auto* t = _inhibited.begin(i); t != _inhibited.end(i); ++t)
+                set_stubborn(*t);
         }
 
         bool StubbornSet::urgent_priority(const TimedTransition* urg_trans, const TimedTransition* trans) const {
@@ -93,13 +126,13 @@ namespace VerifyTAPN {
             assert(_enabled_set.empty());
             const TAPN::TimedTransition *urg_trans = nullptr;
             _gen_enabled.prepare(_parent);
-            std::fill(_enabled.begin(), _enabled.end(), false);
+            _enabled.clear();
 
             do
             {
                 auto [trans, consumes] = _gen_enabled.next_transition();
                 if(trans == nullptr) break;
-                _enabled[trans->getIndex()] = true;
+                _enabled.set(trans->getIndex());
                 monitor(trans);
                 _enabled_set.push_back(trans->getIndex());
                 if (this->urgent_priority(urg_trans, trans) && trans->isUrgent()) {
@@ -108,6 +141,7 @@ namespace VerifyTAPN {
                 }
 
             } while(true);
+            _num_enabled = _enabled_set.size();
             return urg_trans;
         }
 
@@ -150,8 +184,8 @@ namespace VerifyTAPN {
         }
 
         void StubbornSet::set_stubborn(size_t t, bool add_to_working) {
-            if (!_stubborn[t] && this->stubborn_filter(t)) {
-                _stubborn[t] = true;
+            if (!_stubborn.test(t) && this->stubborn_filter(t)) {
+                _stubborn.set(t);
                 //if(add_to_working)
                 {
                     _unprocessed.push_back(t);
@@ -162,11 +196,28 @@ namespace VerifyTAPN {
         }
 
         void StubbornSet::clear_stubborn() {
-            std::fill(_stubborn.begin(), _stubborn.end(), false);
+            _stubborn.clear();
         }
 
         void StubbornSet::prepare(NonStrictMarkingBase *p) {
-            return _prepare(p, [](auto a) {}, []{return true; });
+            _prepare(p, [](auto a) {}, []{return true; });
+            ++_markings;
+            _enabled_total += _num_enabled;
+            if (_can_reduce) {
+                ++_reduced;
+                for (auto t : _enabled_set)
+                    if (_stubborn.test(t)) ++_stubborn_total;
+            } else {
+                _stubborn_total += _num_enabled;
+            }
+        }
+
+        void StubbornSet::print_stats(std::ostream& out) const {
+            out << "  reducible markings:\t" << _reduced << " of " << _markings << std::endl;
+            out << "  fired transitions:\t" << _stubborn_total << " of " << _enabled_total << " enabled";
+            if (_enabled_total > 0)
+                out << " (" << (100.0 * _stubborn_total) / _enabled_total << "%)";
+            out << std::endl;
         }
 
         void StubbornSet::_prepare(NonStrictMarkingBase *p, std::function<void(const TimedTransition*)>&& enabled_monitor, std::function<bool(void)>&& extra_conditions) {
@@ -248,6 +299,7 @@ namespace VerifyTAPN {
             BoolResult context;
             _query->accept(visitor, context);
             _interesting.clear();
+            _interesting.set_marking(*_parent);
             _query->accept(_interesting, context);
 
             // compute the set of unprocessed
@@ -262,7 +314,7 @@ namespace VerifyTAPN {
                 // for now, just pick a single enabled,
                 // verifypn has a good heuristic for this
                 size_t min = 0;
-                size_t max = _enabled.size();
+                size_t max = _tapn.getTransitions().size();
                 if (inv_place) {
                     for (auto* a : inv_place->getInputArcs()) {
                         if (this->is_enabled(a->getOutputTransition().getIndex())) {
@@ -310,14 +362,12 @@ namespace VerifyTAPN {
                 assert(trans);
                 if (this->is_enabled(tr)) {
                     // add everything we might disable in future by fireing
-                    for (auto* a : trans->getPreset())
-                        postset_of(a->getInputPlace().getIndex(), a->getInterval());
-                    for (auto* a : trans->getPostset())
-                        inhib_postset_of(a->getOutputPlace().getIndex());
-                    for (auto* a : trans->getTransportArcs()) {
-                        postset_of(a->getSource().getIndex(), a->getInterval());
-                        inhib_postset_of(a->getDestination().getIndex());
+                    if (!_added_zt) {
+                        for (auto* p = _consumed.begin(tr); p != _consumed.end(tr); ++p)
+                            check_zero_time(*p);
                     }
+                    for (auto* t = _interfering.begin(tr); t != _interfering.end(tr); ++t)
+                        set_stubborn(*t);
                 } else {
                     // find reason for being disabled!
                     if (auto inhib = _gen_enabled.is_inhibited(trans)) {
@@ -327,7 +377,7 @@ namespace VerifyTAPN {
                             uint32_t trans = arc->getOutputTransition().getIndex();
                             auto cons = arc->getOutputTransition().getConsumed(&p);
                             if(cons < arc->getWeight()) continue; // produces more than it consumes
-                            if (!_stubborn[trans]) {
+                            if (!_stubborn.test(trans)) {
                                 for (const auto& t : tl)
                                 {
                                     if (arc->getInterval().contains(t.getAge())) {
@@ -341,7 +391,7 @@ namespace VerifyTAPN {
                             uint32_t trans = arc->getTransition().getIndex();
                             auto cons = arc->getTransition().getConsumed(&p);
                             if(cons < arc->getWeight()) continue; // produces more than it consumes
-                            if (!_stubborn[trans]) {
+                            if (!_stubborn.test(trans)) {
                                 for (const auto& t : tl)
                                 {
                                     if (arc->getInterval().contains(t.getAge())) {
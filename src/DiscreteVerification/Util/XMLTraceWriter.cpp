@@ -0,0 +1,149 @@
+/*
+ * XMLTraceWriter.cpp
+ *
+ * Streaming writer for the XML traces, formatted exactly as rapidxml prints a document.
+ */
+
+#include "DiscreteVerification/Util/XMLTraceWriter.hpp"
+
+#include <cassert>
+
+#define XML_TRACE_BUFFER_SIZE (1 << 16)
+
+namespace VerifyTAPN { namespace DiscreteVerification { namespace Util {
+
+    void XMLTraceWriter::startElement(const std::string& name) {
+        writePending();
+        closeStartTag();
+        indent(_open.size());
+        write('<');
+        write(name);
+        _open.push_back(name);
+        _inStartTag = true;
+    }
+
+    void XMLTraceWriter::attribute(const std::string& name, const std::string& value) {
+        assert(_inStartTag);
+        write(' ');
+        write(name);
+        write('=');
+        // Same quoting as rapidxml: single quotes if the value contains a double quote
+        char quote = value.find('"') != std::string::npos ? '\'' : '"';
+        write(quote);
+        escaped(value, quote == '"' ? '\'' : '"');
+        write(quote);
+    }
+
+    void XMLTraceWriter::endElement() {
+        writePending();
+        assert(!_open.empty());
+        if(_inStartTag) {
+            write("/>");
+            _inStartTag = false;
+        } else {
+            indent(_open.size() - 1);
+            write("</");
+            write(_open.back());
+            write('>');
+        }
+        write('\n');
+        _open.pop_back();
+    }
+
+    void XMLTraceWriter::element(const std::string& name, const std::string& value) {
+        writePending();
+        closeStartTag();
+        indent(_open.size());
+        write('<');
+        write(name);
+        if(value.empty()) {
+            write("/>");
+        } else {
+            write('>');
+            escaped(value, 0);
+            write("</");
+            write(name);
+            write('>');
+        }
+        write('\n');
+    }
+
+    void XMLTraceWriter::pendingElement(const std::string& name, const std::string& value) {
+        writePending();
+        _pendingName = name;
+        _pendingValue = value;
+        _hasPending = true;
+    }
+
+    void XMLTraceWriter::discardPending() {
+        _hasPending = false;
+    }
+
+    void XMLTraceWriter::endDocument() {
+        while(!_open.empty()) {
+            endElement();
+        }
+        writePending();
+        write('\n');
+        flush();
+    }
+
+    void XMLTraceWriter::flush() {
+        if(!_buffer.empty()) {
+            _out.write(_buffer.data(), _buffer.size());
+            _buffer.clear();
+        }
+        _out.flush();
+    }
+
+    void XMLTraceWriter::writePending() {
+        if(!_hasPending) return;
+        _hasPending = false;
+        element(_pendingName, _pendingValue);
+    }
+
+    void XMLTraceWriter::closeStartTag() {
+        if(_inStartTag) {
+            write(">\n");
+            _inStartTag = false;
+        }
+    }
+
+    void XMLTraceWriter::indent(size_t depth) {
+        _buffer.append(depth, '\t');
+    }
+
+    void XMLTraceWriter::escaped(const std::string& value, char noexpand) {
+        for(char c : value) {
+            if(c == noexpand) {
+                write(c);
+                continue;
+            }
+            switch(c) {
+                case '<': write("&lt;"); break;
+                case '>': write("&gt;"); break;
+                case '\'': write("&apos;"); break;
+                case '"': write("&quot;"); break;
+                case '&': write("&amp;"); break;
+                default: write(c); break;
+            }
+        }
+    }
+
+    void XMLTraceWriter::write(const std::string& value) {
+        _buffer.append(value);
+        if(_buffer.size() >= XML_TRACE_BUFFER_SIZE) {
+            _out.write(_buffer.data(), _buffer.size());
+            _buffer.clear();
+        }
+    }
+
+    void XMLTraceWriter::write(char c) {
+        _buffer.push_back(c);
+        if(_buffer.size() >= XML_TRACE_BUFFER_SIZE) {
+            _out.write(_buffer.data(), _buffer.size());
+            _buffer.clear();
+        }
+    }
+
+} } } /* namespace VerifyTAPN */
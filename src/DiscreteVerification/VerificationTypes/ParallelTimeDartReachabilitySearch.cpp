@@ -0,0 +1,158 @@
+/*
+ * ParallelTimeDartReachabilitySearch.cpp
+ *
+ * Time dart reachability search expanding darts on several threads.
+ */
+
+#include "DiscreteVerification/VerificationTypes/ParallelTimeDartReachabilitySearch.hpp"
+#include "DiscreteVerification/QueryVisitor.hpp"
+
+#include <thread>
+
+#define TIME_DART_STORE_SHARDS 1024
+
+namespace VerifyTAPN { namespace DiscreteVerification {
+
+    ParallelTimeDartReachabilitySearch::ParallelTimeDartReachabilitySearch(TAPN::TimedArcPetriNet &tapn,
+                                                                           NonStrictMarkingBase &initialMarking,
+                                                                           AST::Query *query,
+                                                                           const VerificationOptions &options)
+            : TimeDartVerification(tapn, options, query, initialMarking) {
+        nthreads = options.getThreads() > 0 ? options.getThreads() : std::thread::hardware_concurrency();
+        if (nthreads == 0) nthreads = 1;
+        store = std::make_unique<ConcurrentTimeDartStore>(TIME_DART_STORE_SHARDS);
+        frontier = std::make_unique<WorkStealingQueue<ConcurrentTimeDart *>>(nthreads);
+    }
+
+    bool ParallelTimeDartReachabilitySearch::run() {
+        std::vector<std::unique_ptr<Worker>> workers;
+        for (size_t i = 0; i < nthreads; ++i) {
+            workers.emplace_back(std::make_unique<Worker>(tapn, query, tapn.getNumberOfPlaces()));
+        }
+
+        auto *initial = new NonStrictMarkingBase(initialMarking);
+        initial->setGeneratedBy(nullptr);
+        if (!handleSuccessor(0, *workers[0], initial)) {
+            std::vector<std::thread> handles;
+            handles.reserve(nthreads);
+            for (size_t i = 0; i < nthreads; ++i) {
+                handles.emplace_back([this, i, &workers]() { work(i, *workers[i]); });
+            }
+            for (auto &handle : handles) {
+                handle.join();
+            }
+        }
+
+        for (auto &worker : workers) {
+            exploredMarkings += worker->explored;
+            discoveredMarkings += worker->discovered;
+            maxNumTokensInAnyMarking = std::max(maxNumTokensInAnyMarking, worker->maxNumTokens);
+            for (size_t p = 0; p < placeStats.size(); ++p) {
+                placeStats[p] = std::max(placeStats[p], worker->placeStats[p]);
+            }
+            successorGenerator.addTransitionStatistics(worker->generator);
+        }
+        return found;
+    }
+
+    void ParallelTimeDartReachabilitySearch::work(size_t id, Worker &worker) {
+        ConcurrentTimeDart *dart;
+        while (!found.load(std::memory_order_relaxed)) {
+            if (frontier->pop(id, dart)) {
+                int from, to;
+                if (dart->claim(from, to)) {
+                    worker.explored++;
+                    expand(id, worker, *dart, from, to);
+                }
+                frontier->finished();
+            } else if (frontier->empty()) {
+                break;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void ParallelTimeDartReachabilitySearch::expand(size_t id, Worker &worker, ConcurrentTimeDart &dart, int from,
+                                                    int to) {
+        NonStrictMarkingBase *base = dart.getBase();
+        for (auto *t : tapn.getTransitions()) {
+            auto &transition = *t;
+            auto calculatedStart = calculateStart(transition, base);
+            if (calculatedStart.first == -1) {    // Transition cannot be enabled in marking
+                continue;
+            }
+            int start = std::max(from, calculatedStart.first);
+            int end = std::min(to, calculatedStart.second);
+            if (start > end) continue;
+
+            // with an untimed postset every delay in the window leads to the same successors
+            int stop = transition.hasUntimedPostset()
+                       ? start
+                       : std::min(std::max(start, calculateStop(transition, base)), end);
+            for (int n = start; n <= stop; n++) {
+                NonStrictMarkingBase Mpp(*base);
+                Mpp.incrementAge(n);
+                worker.generator.prepare(&Mpp);
+                if (!worker.generator.only_transition(&transition)) continue;
+                while (auto next = worker.generator.next(false)) {
+                    next->setGeneratedBy(worker.generator.last_fired());
+                    if (handleSuccessor(id, worker, next)) return;
+                }
+                if (found.load(std::memory_order_relaxed)) return;
+            }
+        }
+    }
+
+    bool ParallelTimeDartReachabilitySearch::handleSuccessor(size_t id, Worker &worker,
+                                                             NonStrictMarkingBase *marking) {
+        worker.discovered++;
+        int maxDelay = marking->cut(worker.placeStats);
+
+        int size = marking->size();
+        worker.maxNumTokens = std::max(worker.maxNumTokens, size);
+
+        if (size > (int) options.getKBound()) {
+            delete marking;
+            return false;
+        }
+
+        int youngest = 0;
+        if (urgentEnabled(*marking)) {
+            maxDelay = 0;
+        } else {
+            youngest = marking->makeBase();
+        }
+
+        auto [dart, isNew] = store->add(marking, youngest);
+        if (isNew) {
+            if (maxDelay != std::numeric_limits<int>::max())
+                maxDelay += youngest;
+            if (maxDelay > tapn.getMaxConstant()) {
+                maxDelay = tapn.getMaxConstant() + 1;
+            }
+
+            QueryVisitor<NonStrictMarkingBase> checker(*marking, tapn, maxDelay);
+            AST::BoolResult context;
+            {
+                std::lock_guard<std::mutex> guard(queryLock);
+                query->accept(checker, context);
+            }
+            if (context.value) {
+                found = true;
+                return true;
+            }
+        }
+        if (dart != nullptr) {
+            frontier->push(id, dart);
+        }
+        return false;
+    }
+
+    void ParallelTimeDartReachabilitySearch::printStats() {
+        std::cout << "  discovered markings:\t" << discoveredMarkings << std::endl;
+        std::cout << "  explored markings:\t" << exploredMarkings << std::endl;
+        std::cout << "  stored markings:\t" << store->size() << std::endl;
+    }
+
+} } /* namespace VerifyTAPN */
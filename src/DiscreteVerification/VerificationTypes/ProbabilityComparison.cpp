@@ -30,9 +30,8 @@ bool ProbabilityComparison::executeRunFor(AST::SMCQuery* query) {
     bool runRes = false;
     RealMarking* newMarking = runGenerator.getMarking();
     while(!runGenerator.reachedEnd() && !reachedRunBound(query)) {
-        RealMarking* child = new RealMarking(*newMarking);
-        setMaxTokensIfGreater(child->size());
-        runRes = handleSuccessor(query, child);
+        setMaxTokensIfGreater(newMarking->size());
+        runRes = handleSuccessor(query, newMarking);
         if(runRes) break;
         newMarking = runGenerator.next();
     }
@@ -79,8 +78,6 @@ bool ProbabilityComparison::handleSuccessor(AST::SMCQuery* current_query, RealMa
     AST::BoolResult context;
     current_query->accept(checker, context);
 
-    delete marking;
-
     return context.value;
 }
 
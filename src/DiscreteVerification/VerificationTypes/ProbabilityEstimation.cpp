@@ -1,7 +1,11 @@
 #include "DiscreteVerification/VerificationTypes/ProbabilityEstimation.hpp"
 #include "DiscreteVerification/QueryVisitor.hpp"
+#include "DiscreteVerification/Util/Statistics.hpp"
 
 #include <math.h>
+#include <algorithm>
+
+#define MIN_SEQUENTIAL_RUNS 100
 
 namespace VerifyTAPN::DiscreteVerification {
 
@@ -11,40 +15,75 @@ ProbabilityEstimation::ProbabilityEstimation(
 : SMCVerification(tapn, initialMarking, query, options), validRuns(0)
 {
     computeChernoffHoeffdingBound(smcSettings.estimationIntervalWidth, smcSettings.confidence);
+    estimationMethod = options.getSMCEstimationMethod();
+    normalQuantile = Util::inverseNormal((1 + smcSettings.confidence) / 2);
 }
 
 bool ProbabilityEstimation::mustDoAnotherRun() {
-    return numberOfRuns < runsNeeded;
+    if(numberOfRuns >= runsNeeded) return false;
+    if(estimationMethod == VerificationOptions::FIXED_ESTIMATION) return true;
+    return !estimationIntervalReached();
+}
+
+bool ProbabilityEstimation::estimationIntervalReached() {
+    // The interval is only checked on geometrically spaced run counts, which keeps the cost of the check (and the
+    // error added by stopping on the first success of repeated checks) low.
+    if(intervalReached || numberOfRuns < nextIntervalCheck) return intervalReached;
+    nextIntervalCheck = std::max<size_t>(MIN_SEQUENTIAL_RUNS, numberOfRuns + numberOfRuns / 16);
+    if(numberOfRuns < MIN_SEQUENTIAL_RUNS) return false;
+
+    double n = numberOfRuns;
+    double k = validRuns;
+    double p = k / n;
+    double lower, upper;
+    if(estimationMethod == VerificationOptions::WILSON_ESTIMATION) {
+        double z2 = normalQuantile * normalQuantile;
+        double denom = 1 + z2 / n;
+        double center = (p + z2 / (2 * n)) / denom;
+        double half = normalQuantile / denom * sqrt(p * (1 - p) / n + z2 / (4 * n * n));
+        lower = center - half;
+        upper = center + half;
+    } else {
+        // Equal-tailed credible interval of the posterior for a uniform prior
+        double alpha = 1 - smcSettings.confidence;
+        lower = Util::inverseBeta(alpha / 2, k + 1, n - k + 1);
+        upper = Util::inverseBeta(1 - alpha / 2, k + 1, n - k + 1);
+    }
+    double width = smcSettings.estimationIntervalWidth;
+    intervalReached = upper - p <= width && p - lower <= width;
+    if(intervalReached) reachedWidth = std::max(upper - p, p - lower);
+    return intervalReached;
 }
 
 void ProbabilityEstimation::prepare()
 {
-    std::cout << "Need to execute " << runsNeeded << " runs to produce estimation" << std::endl;
+    if(estimationMethod == VerificationOptions::FIXED_ESTIMATION) {
+        std::cout << "Need to execute " << runsNeeded << " runs to produce estimation" << std::endl;
+    } else {
+        std::cout << "Need to execute at most " << runsNeeded << " runs to produce estimation" << std::endl;
+    }
 }
 
 void ProbabilityEstimation::handleRunResult(const bool decisive, int steps, double delay)
 {
     //bool valid = (query->getQuantifier() == PF && decisive) || (query->getQuantifier() == PG && !decisive);
+    runSteps.add(steps);
+    runDelays.add(delay);
     if(decisive) {
         validRuns++;
-        validRunsTime += delay;
-        validRunsSteps += steps;
+        validSteps.add(steps);
+        validDelays.add(delay);
         if(validPerStep.size() <= steps) {
             validPerStep.resize(steps + 1, 0);
         }
         validPerStep[steps] += 1;
-        validPerDelay.push_back(delay);
+        validPerDelay.add(delay);
         if(delay > maxValidDuration) {
             maxValidDuration = delay;
         }
     } else {
-        violatingRunTime += delay;
-        violatingRunSteps += steps;
-        if(violatingPerStep.size() <= steps) {
-            violatingPerStep.resize(steps + 1, 0);
-        }
-        violatingPerStep[steps] += 1;
-        violatingPerDelay.push_back(delay);
+        violatingSteps.add(steps);
+        violatingDelays.add(delay);
     }
 }
 
@@ -53,8 +92,6 @@ bool ProbabilityEstimation::handleSuccessor(RealMarking* marking) {
     AST::BoolResult context;
     query->accept(checker, context);
 
-    delete marking;
-
     return context.value;
 }
 
@@ -71,6 +108,9 @@ void ProbabilityEstimation::computeChernoffHoeffdingBound(const float intervalWi
 
 void ProbabilityEstimation::printStats() {
     SMCVerification::printStats();
+    if(estimationMethod != VerificationOptions::FIXED_ESTIMATION) {
+        std::cout << "  runs saved by early stopping:\t" << (runsNeeded - numberOfRuns) << std::endl;
+    }
     printGlobalRunsStats();
     printValidRunsStats();
     printViolatingRunsStats();
@@ -80,67 +120,38 @@ void ProbabilityEstimation::printStats() {
 void ProbabilityEstimation::printValidRunsStats() {
     std::string category = "valid";
     if(query->getQuantifier() == PF) {
-        printRunsStats(category, validRuns, validRunsSteps, validRunsTime, validPerStep, validPerDelay);
+        printRunsStats(category, validSteps, validDelays);
     } else {
-        printRunsStats(category, numberOfRuns - validRuns, violatingRunSteps, violatingRunTime, violatingPerStep, violatingPerDelay);
+        printRunsStats(category, violatingSteps, violatingDelays);
     }
 }
 
 void ProbabilityEstimation::printViolatingRunsStats() {
     std::string category = "violating";
     if(query->getQuantifier() == PG) {
-        printRunsStats(category, validRuns, validRunsSteps, validRunsTime, validPerStep, validPerDelay);
+        printRunsStats(category, validSteps, validDelays);
     } else {
-        printRunsStats(category, numberOfRuns - validRuns, violatingRunSteps, violatingRunTime, violatingPerStep, violatingPerDelay);
+        printRunsStats(category, violatingSteps, violatingDelays);
     }
 }
 
-void ProbabilityEstimation::printRunsStats(const std::string category, unsigned long n, unsigned long totalSteps, double totalDelay, std::vector<int> perStep, std::vector<float> perDelay) {
+void ProbabilityEstimation::printRunsStats(const std::string category, const Util::RunningStatistics& steps, const Util::RunningStatistics& delays) {
+    unsigned long n = steps.count();
     if(n == 0) {
         std::cout << "  no " + category + " runs, unable to compute specific statistics" << std::endl;
         return;
     }
-    double stepsMean = (totalSteps / (double) n);
-    double timeMean = (totalDelay / n);
-    double stepsAcc = 0;
-    double delayAcc = 0;
-    for(int i = 0 ; i < perStep.size() ; i++) {
-        stepsAcc += pow(i - stepsMean, 2.0) * perStep[i];
-    }
-    for(int i = 0 ; i < perDelay.size() ; i++) {
-        delayAcc += pow(perDelay[i] - timeMean, 2.0);
-    }
-    double stepsStdDev = sqrt( stepsAcc / n );
-    double delayStdDev = sqrt( delayAcc / n );
     std::cout << "  statistics of " + category + " runs:" << std::endl;
     std::cout << "    number of " << category << " runs: " << n << std::endl;
-    std::cout << "    duration of a " + category + " run (average):\t" << timeMean << std::endl;
-    std::cout << "    duration of a " + category + " run (std. dev.):\t" << delayStdDev << std::endl;
-    std::cout << "    length of a " + category + " run (average):\t" << stepsMean << std::endl;
-    std::cout << "    length of a " + category + " run (std. dev.):\t" << stepsStdDev << std::endl;
+    std::cout << "    duration of a " + category + " run (average):\t" << delays.mean() << std::endl;
+    std::cout << "    duration of a " + category + " run (std. dev.):\t" << delays.stdDev() << std::endl;
+    std::cout << "    length of a " + category + " run (average):\t" << steps.mean() << std::endl;
+    std::cout << "    length of a " + category + " run (std. dev.):\t" << steps.stdDev() << std::endl;
 }
 
 void ProbabilityEstimation::printGlobalRunsStats() {
-    double stepsMean = (totalSteps / (double) numberOfRuns);
-    double timeMean = (totalTime / numberOfRuns);
-    double stepsAcc = 0;
-    double delayAcc = 0;
-    for(int i = 0 ; i < validPerStep.size() ; i++) {
-        stepsAcc += pow(i - stepsMean, 2.0) * validPerStep[i];
-    }
-    for(int i = 0 ; i < violatingPerStep.size() ; i++) {
-        stepsAcc += pow(i - stepsMean, 2.0) * violatingPerStep[i];
-    }
-    for(int i = 0 ; i < validPerDelay.size() ; i++) {
-        delayAcc += pow(validPerDelay[i] - timeMean, 2.0);
-    }
-    for(int i = 0 ; i < violatingPerDelay.size() ; i++) {
-        delayAcc += pow(violatingPerDelay[i] - timeMean, 2.0);
-    }
-    double stepsStdDev = sqrt( stepsAcc / numberOfRuns );
-    double delayStdDev = sqrt( delayAcc / numberOfRuns );
-    std::cout << "  run duration (std. dev.):\t" << delayStdDev << std::endl;
-    std::cout << "  run length (std. dev.):\t" << stepsStdDev << std::endl;
+    std::cout << "  run duration (std. dev.):\t" << runDelays.stdDev() << std::endl;
+    std::cout << "  run length (std. dev.):\t" << runSteps.stdDev() << std::endl;
 }
 
 void ProbabilityEstimation::printCumulativeStats() {
@@ -180,13 +191,15 @@ void ProbabilityEstimation::printCumulativeStats() {
     acc = initial;
     binSize = timeScale == 0 ? 1 : (maxValidDuration / (double) timeScale);
     std::vector<double> bins(
-        binSize > 0 ? (size_t) round(maxValidDuration / binSize) : 1
+        binSize > 0 ? std::max<size_t>(1, (size_t) round(maxValidDuration / binSize)) : 1
         , 0.0f);
     lastAcc = acc;
-    for(int i = 0 ; i < validPerDelay.size() ; i++) {
-        double delay = validPerDelay[i];
-        int binIndex = std::min((size_t) round(delay / binSize), bins.size() - 1);
-        bins[binIndex] += 1;
+    // The delays are only known up to the histogram's bins, which are much finer than the printed ones
+    for(size_t i = 0 ; i < validPerDelay.bins() ; i++) {
+        if(validPerDelay.count(i) == 0) continue;
+        double delay = std::min(validPerDelay.center(i), (double) maxValidDuration);
+        size_t binIndex = binSize > 0 ? std::min((size_t) round(delay / binSize), bins.size() - 1) : 0;
+        bins[binIndex] += validPerDelay.count(i);
     }
     std::cout << 0 << ":" << acc << ";";
     for(int i = 0 ; i < bins.size() ; i++) {
@@ -213,7 +226,8 @@ void ProbabilityEstimation::printResult() {
         printHumanTrace(m, printStack, query->getQuantifier());
     }*/
     float result = getEstimation();
-    float width = smcSettings.estimationIntervalWidth;
+    // Stopping early means the interval reached is within the requested width
+    float width = intervalReached ? reachedWidth : smcSettings.estimationIntervalWidth;
     std::cout << "Probability estimation:" << std::endl;
     std::cout << "\tConfidence: " << smcSettings.confidence * 100 << "%" << std::endl;
     std::cout << "\tP = " << result << " ± " << width << std::endl;
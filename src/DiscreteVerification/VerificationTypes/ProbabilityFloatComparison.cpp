@@ -2,6 +2,13 @@
 #include "DiscreteVerification/QueryVisitor.hpp"
 
 #include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <map>
+
+#define SPRT_BATCH_SIZE 32
+#define SPRT_WINDOW_BATCHES 64
 
 namespace VerifyTAPN::DiscreteVerification {
 
@@ -14,6 +21,78 @@ ProbabilityFloatComparison::ProbabilityFloatComparison(
     computeIndifferenceRegion(smcSettings.geqThan, smcSettings.indifferenceRegionUp, smcSettings.indifferenceRegionDown);
 }
 
+bool ProbabilityFloatComparison::parallel_run() {
+    prepare();
+    runGenerator.prepare(&initialMarking);
+    auto start = std::chrono::steady_clock::now();
+
+    size_t n_threads = options.getSmcThreads() > 0 ? options.getSmcThreads() : std::thread::hardware_concurrency();
+    if(n_threads == 0) n_threads = 1;
+    std::cout << ". Using " << n_threads << " threads..." << std::endl;
+
+    // Runs are numbered by batches when they are started, and the test only consumes them in that order: stopping
+    // on the runs that happen to finish first would favour short runs and break the error bounds of the test.
+    std::atomic<bool> done(false);
+    std::atomic<size_t> claimed(0);
+    std::atomic<size_t> nextRun(0);
+    std::map<size_t, std::vector<SMCRunResult>> pending;
+    const size_t window = n_threads * SPRT_BATCH_SIZE * SPRT_WINDOW_BATCHES;
+    std::vector<std::thread> handles;
+    handles.reserve(n_threads);
+    for(size_t i = 0 ; i < n_threads ; i++) {
+        handles.emplace_back([this, i, window, start, &done, &claimed, &nextRun, &pending]() {
+            SMCRunGenerator generator = runGenerator.copy();
+            if(options.hasSeed()) {
+                generator.setSeed(options.getSeed(), i);
+                generator.reset();
+            }
+            std::vector<SMCRunResult> batch;
+            while(!done) {
+                size_t first = claimed.fetch_add(SPRT_BATCH_SIZE);
+                // Waits for the batches before this one rather than buffering results without bound
+                while(!done && first >= nextRun + window) std::this_thread::yield();
+                batch.reserve(SPRT_BATCH_SIZE);
+                while(batch.size() < SPRT_BATCH_SIZE && !done) {
+                    bool runRes = executeRun(&generator);
+                    double runDuration = std::min(generator.getRunDelay(), (double) smcSettings.timeBound);
+                    int runSteps = std::min(generator.getRunSteps(), smcSettings.stepBound);
+                    batch.push_back({ runRes, runSteps, runDuration });
+                    generator.reset();
+                }
+                if(done) break;
+                std::lock_guard<std::mutex> lock(run_res_mutex);
+                simulatedRuns += batch.size();
+                pending.emplace(first, std::move(batch));
+                batch.clear();
+                while(!done && !pending.empty() && pending.begin()->first == nextRun) {
+                    for(auto& result : pending.begin()->second) {
+                        if(!mustDoAnotherRun()) break;
+                        totalTime += result.duration;
+                        totalSteps += result.steps;
+                        numberOfRuns++;
+                        handleRunResult(result.res, result.steps, result.duration);
+                    }
+                    nextRun += SPRT_BATCH_SIZE;
+                    pending.erase(pending.begin());
+                    if(!mustDoAnotherRun()) {
+                        decisionNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start).count();
+                        done = true;
+                    }
+                }
+            }
+        });
+    }
+    for(auto& handle : handles) {
+        handle.join();
+    }
+
+    auto stop = std::chrono::steady_clock::now();
+    durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+
+    return true;
+}
+
 void ProbabilityFloatComparison::handleRunResult(const bool res, int steps, double delay) {
     bool valid = query->getQuantifier() == PG ? !res : res;
     if(p0 >= 1.0f && !valid) {
@@ -29,8 +108,6 @@ bool ProbabilityFloatComparison::handleSuccessor(RealMarking* marking) {
     AST::BoolResult context;
     query->accept(checker, context);
 
-    delete marking;
-
     return context.value;
 }
 
@@ -62,6 +139,10 @@ void ProbabilityFloatComparison::computeIndifferenceRegion(const float p, const
 void ProbabilityFloatComparison::printStats() {
     SMCVerification::printStats();
     std::cout << "  valid runs:\t" << validRuns << std::endl;
+    if(decisionNs > 0) {
+        std::cout << "  runs simulated:\t" << simulatedRuns << std::endl;
+        std::cout << "  time to decision:\t" << ((double) decisionNs / 1.0E9) << "s" << std::endl;
+    }
 }
 
 void ProbabilityFloatComparison::printResult() {
@@ -0,0 +1,160 @@
+#include "DiscreteVerification/VerificationTypes/ProbabilitySplitting.hpp"
+#include "DiscreteVerification/QueryVisitor.hpp"
+#include "DiscreteVerification/DistanceQueryVisitor.hpp"
+#include "DiscreteVerification/Util/Statistics.hpp"
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <math.h>
+
+namespace VerifyTAPN::DiscreteVerification {
+
+bool ProbabilitySplitting::mustDoAnotherRun() {
+    return estimates.size() < options.getSmcSplittingReplications();
+}
+
+void ProbabilitySplitting::handleRunResult(const bool, int, double)
+{
+
+}
+
+bool ProbabilitySplitting::handleSuccessor(RealMarking* marking) {
+    QueryVisitor<RealMarking> checker(*marking, tapn);
+    AST::BoolResult context;
+    query->accept(checker, context);
+    return context.value;
+}
+
+int ProbabilitySplitting::distance(RealMarking* marking) {
+    DistanceQueryVisitor<RealMarking> visitor(*marking, tapn);
+    return visitor.distance(*query);
+}
+
+void ProbabilitySplitting::prepare()
+{
+    std::cout << "Need to execute " << options.getSmcSplittingReplications() << " splitting estimations of "
+              << options.getSmcSplitting() << " runs per level" << std::endl;
+}
+
+double ProbabilitySplitting::splittingEstimate(SMCRunGenerator& generator) {
+    const size_t effort = std::max(1u, options.getSmcSplitting());
+    size_t runs = 0;
+    unsigned long steps = 0;
+    double time = 0;
+
+    generator.reset();
+    int level = distance(generator.getMarking());
+    if(level == std::numeric_limits<int>::max()) {
+        addEstimate(0, 0, 0, 0);
+        return 0;
+    }
+    std::vector<SMCRunState> starts { generator.saveState() };
+    std::vector<SMCRunState> entered;
+    double estimate = 1;
+    while(level > 0 && estimate > 0) {
+        // The runs are spread evenly over the states that entered the current level, which keeps the product of the
+        // fractions unbiased. A run can skip levels, it then enters the following ones right away.
+        entered.clear();
+        for(size_t i = 0 ; i < effort ; i++) {
+            const SMCRunState& start = starts[i % starts.size()];
+            generator.restoreState(start);
+            RealMarking* marking = generator.getMarking();
+            while(!generator.reachedEnd() && !reachedRunBound(&generator)) {
+                if(distance(marking) < level) {
+                    entered.push_back(generator.saveState());
+                    break;
+                }
+                marking = generator.next();
+            }
+            runs++;
+            steps += std::min(generator.getRunSteps(), smcSettings.stepBound) - start.totalSteps;
+            time += std::min(generator.getRunDelay(), (double) smcSettings.timeBound) - start.totalTime;
+        }
+        estimate *= entered.size() / (double) effort;
+        starts.swap(entered);
+        level--;
+    }
+    addEstimate(estimate, runs, steps, time);
+    return estimate;
+}
+
+void ProbabilitySplitting::addEstimate(double estimate, size_t runs, unsigned long steps, double time) {
+    std::lock_guard<std::mutex> lock(run_res_mutex);
+    if(!mustDoAnotherRun()) return;
+    estimates.push_back(estimate);
+    numberOfRuns += runs;
+    totalSteps += steps;
+    totalTime += time;
+}
+
+bool ProbabilitySplitting::run() {
+    prepare();
+    if(options.hasSeed()) runGenerator.setSeed(options.getSeed());
+    runGenerator.prepare(&initialMarking);
+    auto start = std::chrono::steady_clock::now();
+    while(mustDoAnotherRun()) {
+        splittingEstimate(runGenerator);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+    return true;
+}
+
+bool ProbabilitySplitting::parallel_run() {
+    prepare();
+    runGenerator.prepare(&initialMarking);
+    auto start = std::chrono::steady_clock::now();
+
+    size_t n_threads = options.getSmcThreads() > 0 ? options.getSmcThreads() : std::thread::hardware_concurrency();
+    if(n_threads == 0) n_threads = 1;
+    std::cout << ". Using " << n_threads << " threads..." << std::endl;
+
+    // Replications are handed out one at a time, so no thread starts one that will be dropped
+    std::atomic<size_t> started(0);
+    const size_t replications = options.getSmcSplittingReplications();
+    std::vector<std::thread> handles;
+    handles.reserve(n_threads);
+    for(size_t i = 0 ; i < n_threads ; i++) {
+        handles.emplace_back([this, i, &started, replications]() {
+            SMCRunGenerator generator = runGenerator.copy();
+            if(options.hasSeed()) generator.setSeed(options.getSeed(), i);
+            while(started++ < replications) {
+                splittingEstimate(generator);
+            }
+        });
+    }
+    for(auto& handle : handles) {
+        handle.join();
+    }
+
+    auto stop = std::chrono::steady_clock::now();
+    durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+
+    return true;
+}
+
+float ProbabilitySplitting::getEstimation() {
+    double proba = 0;
+    for(double estimate : estimates) proba += estimate;
+    proba /= estimates.size();
+    return (query->getQuantifier() == PG) ? 1 - proba : proba;
+}
+
+void ProbabilitySplitting::printResult() {
+    float result = getEstimation();
+    double n = estimates.size();
+    double mean = 0;
+    for(double estimate : estimates) mean += estimate;
+    mean /= n;
+    double acc = 0;
+    for(double estimate : estimates) acc += pow(estimate - mean, 2.0);
+    double stdDev = sqrt(acc / (n - 1));
+    double width = Util::inverseStudent((1 + smcSettings.confidence) / 2, n - 1) * stdDev / sqrt(n);
+    std::cout << "Probability estimation:" << std::endl;
+    std::cout << "\tConfidence: " << smcSettings.confidence * 100 << "%" << std::endl;
+    std::cout << "\tP = " << result << " ± " << width << std::endl;
+    std::cout << "\tRelative error: " << (mean > 0 ? width / mean : 0) << std::endl;
+}
+
+}
@@ -25,7 +25,6 @@ bool SMCTracesGenerator::handleSuccessor(RealMarking* marking) {
     QueryVisitor<RealMarking> checker(*marking, tapn);
     AST::BoolResult context;
     query->accept(checker, context);
-    delete marking;
     return context.value;
 }
 
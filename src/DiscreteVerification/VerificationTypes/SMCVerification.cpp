@@ -1,12 +1,15 @@
 #include "DiscreteVerification/VerificationTypes/SMCVerification.hpp"
 
 #include <thread>
+#include <atomic>
 #include <sstream>
 #include <chrono>
 #include <iomanip>
 #include <algorithm>
 
 #define STEP_MS 5000
+#define RUN_BATCH_SIZE 32
+#define BATCH_RUNS_PER_LANE 16
 
 std::string printDouble(double value, unsigned int precision) {
     std::ostringstream oss;
@@ -23,36 +26,102 @@ bool SMCVerification::parallel_run() {
     runGenerator.recordTrace = mustSaveTrace();
     auto start = std::chrono::steady_clock::now();
 
-    size_t n_threads = std::thread::hardware_concurrency();
+    size_t n_threads = options.getSmcThreads() > 0 ? options.getSmcThreads() : std::thread::hardware_concurrency();
+    if(n_threads == 0) n_threads = 1;
     std::cout << ". Using " << n_threads << " threads..." << std::endl;
 
-    std::vector<std::thread*> handles;
-    for(int i = 0 ; i < n_threads ; i++) {
-        auto handle = new std::thread([this]() {
+    std::atomic<bool> done(false);
+    std::vector<std::thread> handles;
+    handles.reserve(n_threads);
+    for(size_t i = 0 ; i < n_threads ; i++) {
+        handles.emplace_back([this, i, &done]() {
             SMCRunGenerator generator = runGenerator.copy();
-            bool continueExecution = true;
-            while(continueExecution) {
-                bool runRes = executeRun(&generator);
-                double runDuration = std::min(generator.getRunDelay(), (double) smcSettings.timeBound);
-                int runSteps = std::min(generator.getRunSteps(), smcSettings.stepBound);
+            if(options.hasSeed()) {
+                generator.setSeed(options.getSeed(), i);
+                generator.reset();
+            }
+            std::vector<SMCRunResult> batch;
+            batch.reserve(RUN_BATCH_SIZE);
+            while(!done) {
+                // Traces are taken from the generator, so runs are merged one at a time while recording.
+                size_t batchSize = generator.recordTrace ? 1 : RUN_BATCH_SIZE;
+                while(batch.size() < batchSize && !done) {
+                    bool runRes = executeRun(&generator);
+                    double runDuration = std::min(generator.getRunDelay(), (double) smcSettings.timeBound);
+                    int runSteps = std::min(generator.getRunSteps(), smcSettings.stepBound);
+                    batch.push_back({ runRes, runSteps, runDuration });
+                    if(batch.size() < batchSize) generator.reset();
+                }
                 {
                     std::lock_guard<std::mutex> lock(run_res_mutex);
-                    totalTime += runDuration;
-                    totalSteps += runSteps;
-                    numberOfRuns++;
-                    handleRunResult(runRes, runSteps, runDuration);
-                    if(mustSaveTrace()) handleTrace(runRes, &generator);
+                    for(auto& result : batch) {
+                        if(!mustDoAnotherRun()) break;
+                        totalTime += result.duration;
+                        totalSteps += result.steps;
+                        numberOfRuns++;
+                        handleRunResult(result.res, result.steps, result.duration);
+                        if(mustSaveTrace()) handleTrace(result.res, &generator);
+                    }
                     generator.recordTrace = mustSaveTrace();
-                    continueExecution = mustDoAnotherRun();
+                    if(!mustDoAnotherRun()) done = true;
                 }
+                batch.clear();
                 generator.reset();
             }
         });
-        handles.push_back(handle);
     }
-    for(int i = 0 ; i < n_threads ; i++) {
-        handles[i]->join();
-        delete handles[i];
+    for(auto& handle : handles) {
+        handle.join();
+    }
+
+    auto stop = std::chrono::steady_clock::now();
+    durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+
+    return true;
+}
+
+bool SMCVerification::batch_run() {
+    prepare();
+    runGenerator.prepare(&initialMarking);
+    auto start = std::chrono::steady_clock::now();
+
+    size_t n_threads = 1;
+    if(options.isParallel()) {
+        n_threads = options.getSmcThreads() > 0 ? options.getSmcThreads() : std::thread::hardware_concurrency();
+        if(n_threads == 0) n_threads = 1;
+    }
+    size_t lanes = options.getSmcBatch();
+    std::cout << ". Simulating batches of " << lanes << " runs using " << n_threads << " threads..." << std::endl;
+
+    std::atomic<bool> done(false);
+    std::vector<std::thread> handles;
+    handles.reserve(n_threads);
+    for(size_t i = 0 ; i < n_threads ; i++) {
+        handles.emplace_back([this, i, lanes, &done]() {
+            SMCBatchRunGenerator generator(tapn, lanes, options.getSMCNumericPrecision());
+            if(options.hasSeed()) generator.setSeed(options.getSeed(), i);
+            generator.prepare(&initialMarking);
+            std::vector<SMCRunResult> results;
+            while(!done) {
+                // Lanes are refilled until every run of the chunk is done, so the chunk spans several runs per lane
+                // to keep the lanes busy; results come in start order and the surplus is simply dropped.
+                generator.simulate(query, smcSettings.timeBound, smcSettings.stepBound, lanes * BATCH_RUNS_PER_LANE, results);
+                std::lock_guard<std::mutex> lock(run_res_mutex);
+                for(auto& result : results) {
+                    if(!mustDoAnotherRun()) break;
+                    totalTime += result.duration;
+                    totalSteps += result.steps;
+                    numberOfRuns++;
+                    handleRunResult(result.res, result.steps, result.duration);
+                }
+                if(!mustDoAnotherRun()) done = true;
+            }
+            std::lock_guard<std::mutex> lock(run_res_mutex);
+            runGenerator.addTransitionStatistics(generator.getTransitionStatistics());
+        });
+    }
+    for(auto& handle : handles) {
+        handle.join();
     }
 
     auto stop = std::chrono::steady_clock::now();
@@ -63,6 +132,7 @@ bool SMCVerification::parallel_run() {
 
 bool SMCVerification::run() {
     prepare();
+    if(options.hasSeed()) runGenerator.setSeed(options.getSeed());
     runGenerator.recordTrace = mustSaveTrace();
     runGenerator.prepare(&initialMarking);
     auto start = std::chrono::steady_clock::now();
@@ -100,8 +170,8 @@ bool SMCVerification::executeRun(SMCRunGenerator* generator) {
     if(generator == nullptr) generator = &runGenerator;
     RealMarking* newMarking = generator->getMarking();
     while(!generator->reachedEnd() && !reachedRunBound(generator)) {
-        RealMarking* child = new RealMarking(*newMarking);
-        runRes = handleSuccessor(child);
+        // The query is checked on the generator's live marking, which stays owned by the generator
+        runRes = handleSuccessor(newMarking);
         if(runRes) break;
         newMarking = generator->next();
     }
@@ -113,6 +183,9 @@ void SMCVerification::printStats() {
     std::cout << "  average run length:\t" << (totalSteps / (double) numberOfRuns) << std::endl;
     std::cout << "  average run duration:\t" << (totalTime / (double) numberOfRuns) << std::endl;
     std::cout << "  verification time:\t" << ((double) durationNs / 1.0E9) << "s" << std::endl;
+    if(options.isBenchmarkMode()) {
+        std::cout << "  runs per second:\t" << (numberOfRuns / ((double) durationNs / 1.0E9)) << std::endl;
+    }
 }
 
 void SMCVerification::printTransitionStatistics() const {
@@ -155,125 +228,107 @@ void SMCVerification::saveTrace(SMCRunGenerator* generator) {
 }
 
 void SMCVerification::getTrace() {
-    using namespace rapidxml;
     std::cerr << "Trace: " << std::endl;
     if(options.getXmlTrace()) {
-        xml_document<> doc;
-        xml_node<> *root = doc.allocate_node(node_element, "trace-list");
-        doc.append_node(root);
-        for(int i = 0 ; i < traces.size() ; i++) {
+        Util::XMLTraceWriter writer(std::cerr);
+        writer.startElement("trace-list");
+        for(size_t i = 0 ; i < traces.size() ; i++) {
             std::string name = "Simulation" + std::to_string(i + 1);
-            auto& stack = traces[i];
-            printXMLTrace(stack, name, doc, root);
+            printXMLTrace(traces[i], name, writer);
         }
-        std::cerr << doc;
+        writer.endDocument();
     } else {
-        for(int i = 0 ; i < traces.size() ; i++) {
+        for(size_t i = 0 ; i < traces.size() ; i++) {
             std::string name = "Simulation" + std::to_string(i + 1);
-            auto& stack = traces[i];
-            printHumanTrace(stack, name);
+            printHumanTrace(traces[i], name);
         }
     }
 }
 
-void SMCVerification::printHumanTrace(std::stack<RealMarking *> &stack, const std::string& name) {
+void SMCVerification::printHumanTrace(const SMCTrace& trace, const std::string& name) {
     bool isFirst = true;
     std::cout << "Name: " << name << std::endl;
-    while (!stack.empty()) {
+    trace.replay(tapn, [&](RealMarking*, RealMarking& marking) {
         if (isFirst) {
             isFirst = false;
         } else {
-            RealMarking* marking = stack.top();
-            if(marking->getPreviousDelay() > 0) {
-                std::cout << "\tDelay: " << marking->getPreviousDelay() << std::endl;
+            if(marking.getPreviousDelay() > 0) {
+                std::cout << "\tDelay: " << marking.getPreviousDelay() << std::endl;
             }
-            if(marking->getGeneratedBy() != nullptr) {
-                std::cout << "\tTransition:" << marking->getGeneratedBy()->getName() << std::endl;
+            if(marking.getGeneratedBy() != nullptr) {
+                std::cout << "\tTransition:" << marking.getGeneratedBy()->getName() << std::endl;
             }
-            if(marking->canDeadlock(tapn, 0)) {
+            if(marking.canDeadlock(tapn, 0)) {
                 std::cout << "\tDeadlock: " << std::endl;
             }
         }
         std::cout << "Marking: ";
-        for (auto& token_list : stack.top()->getPlaceList()) {
+        for (auto& token_list : marking.getPlaceList()) {
             for (auto& token : token_list.tokens) {
                 for (int i = 0; i < token.getCount(); i++) {
-                    std::cout << "(" << token_list.place->getName() << "," << token.getAge() << ") ";
+                    std::cout << "(" << token_list.place->getName() << "," << marking.getAge(token) << ") ";
                 }
             }
         }
-        stack.pop();
-    }
+    });
 }
 
-void SMCVerification::printXMLTrace(std::stack<RealMarking *> &stack, const std::string& name, rapidxml::xml_document<> &doc, rapidxml::xml_node<>* list_node) {
-    using namespace rapidxml;
+void SMCVerification::printXMLTrace(const SMCTrace& trace, const std::string& name, Util::XMLTraceWriter &writer) {
     bool isFirst = true;
-    RealMarking *old = nullptr;
-    xml_node<> *root = doc.allocate_node(node_element, "trace");
-    xml_attribute<> *name_attr = doc.allocate_attribute("name", doc.allocate_string(name.c_str()));
-    root->append_attribute(name_attr);
-    list_node->append_node(root);
-    while (!stack.empty()) {
+    writer.startElement("trace");
+    writer.attribute("name", name);
+    trace.replay(tapn, [&](RealMarking* old, RealMarking& marking) {
         if (isFirst) {
             isFirst = false;
-        } else {
-            RealMarking* marking = stack.top();
-            if(marking->getPreviousDelay() > 0) {
-                std::string str = printDouble(marking->getPreviousDelay(), options.getSMCNumericPrecision());
-                xml_node<>* node = doc.allocate_node(node_element, "delay", doc.allocate_string(str.c_str()));
-                root->append_node(node);
-            }
-            if(marking->getGeneratedBy() != nullptr) {
-                root->append_node(createTransitionNode(old, marking, doc));
-            }
-            if(marking->canDeadlock(tapn, 0)) {
-                root->append_node(doc.allocate_node(node_element, "deadlock"));
-            }
+            return;
         }
-        old = stack.top();
-        stack.pop();
-    }
+        if(marking.getPreviousDelay() > 0) {
+            writer.element("delay", printDouble(marking.getPreviousDelay(), options.getSMCNumericPrecision()));
+        }
+        if(marking.getGeneratedBy() != nullptr) {
+            printTransition(writer, old, &marking);
+        }
+        if(marking.canDeadlock(tapn, 0)) {
+            writer.element("deadlock");
+        }
+    });
+    writer.endElement();
 }
 
-rapidxml::xml_node<> *SMCVerification::createTransitionNode(RealMarking *old, RealMarking *current, rapidxml::xml_document<> &doc) {
-    using namespace rapidxml;
-    xml_node<> *transitionNode = doc.allocate_node(node_element, "transition");
-    xml_attribute<> *id = doc.allocate_attribute("id", current->getGeneratedBy()->getId().c_str());
-    transitionNode->append_attribute(id);
+void SMCVerification::printTransition(Util::XMLTraceWriter &writer, RealMarking *old, RealMarking *current) {
+    writer.startElement("transition");
+    writer.attribute("id", current->getGeneratedBy()->getId());
 
     for (auto* arc : current->getGeneratedBy()->getPreset()) {
-        createTransitionSubNodes(old, current, doc, transitionNode, arc->getInputPlace(),
-                                     arc->getInterval(), arc->getWeight());
+        printTransitionTokens(writer, old, current, arc->getInputPlace(), arc->getInterval(), arc->getWeight());
     }
 
     for (auto* arc : current->getGeneratedBy()->getTransportArcs()) {
-        createTransitionSubNodes(old, current, doc, transitionNode, arc->getSource(),
-                                     arc->getInterval(), arc->getWeight());
+        printTransitionTokens(writer, old, current, arc->getSource(), arc->getInterval(), arc->getWeight());
     }
 
-    return transitionNode;
+    writer.endElement();
 }
 
-void SMCVerification::createTransitionSubNodes(RealMarking *old, RealMarking *current, rapidxml::xml_document<> &doc,
-                                rapidxml::xml_node<> *transitionNode, const TAPN::TimedPlace &place,
-                                const TAPN::TimeInterval &interval, int weight) {
-    RealTokenList current_tokens = current->getTokenList(place.getIndex());
-    RealTokenList old_tokens = old->getTokenList(place.getIndex());
+void SMCVerification::printTransitionTokens(Util::XMLTraceWriter &writer, RealMarking *old, RealMarking *current,
+                                const TAPN::TimedPlace &place, const TAPN::TimeInterval &interval, int weight) {
+    const RealTokenList& current_tokens = current->getTokenList(place.getIndex());
+    const RealTokenList& old_tokens = old->getTokenList(place.getIndex());
     int tokensFound = 0;
+    // current is old after firing, so both have the same clock and their stored ages can be compared
     RealTokenList::const_iterator n_iter = current_tokens.begin();
     RealTokenList::const_iterator o_iter = old_tokens.begin();
     while (n_iter != current_tokens.end() && o_iter != old_tokens.end()) {
         if (n_iter->getAge() == o_iter->getAge()) {
             for (int i = 0; i < o_iter->getCount() - n_iter->getCount(); i++) {
-                transitionNode->append_node(createTokenNode(doc, place, *n_iter));
+                printToken(writer, place, current->getAge(*n_iter));
                 tokensFound++;
             }
             n_iter++;
             o_iter++;
         } else {
             if (n_iter->getAge() > o_iter->getAge()) {
-                transitionNode->append_node(createTokenNode(doc, place, *o_iter));
+                printToken(writer, place, old->getAge(*o_iter));
                 tokensFound++;
                 o_iter++;
             } else {
@@ -283,33 +338,26 @@ void SMCVerification::createTransitionSubNodes(RealMarking *old, RealMarking *cu
     }
     for (RealTokenList::const_iterator iter = n_iter; iter != current_tokens.end(); iter++) {
         for (int i = 0; i < iter->getCount(); i++) {
-            transitionNode->append_node(createTokenNode(doc, place, *iter));
+            printToken(writer, place, current->getAge(*iter));
             tokensFound++;
         }
     }
     for (auto& token : old_tokens) {
         if(tokensFound >= weight) break;
-        if (token.getAge() >= interval.getLowerBound()) {
+        if (old->getAge(token) >= interval.getLowerBound()) {
             for (int i = 0; i < token.getCount() && tokensFound < weight; i++) {
-                transitionNode->append_node(createTokenNode(doc, place, token));
+                printToken(writer, place, old->getAge(token));
                 tokensFound++;
             }
         }
     }
 }
 
-rapidxml::xml_node<> *
-SMCVerification::createTokenNode(rapidxml::xml_document<> &doc, const TAPN::TimedPlace &place, const RealToken &token) {
-    using namespace rapidxml;
-    xml_node<> *tokenNode = doc.allocate_node(node_element, "token");
-    xml_attribute<> *placeAttribute = doc.allocate_attribute("place",
-                                                                doc.allocate_string(place.getName().c_str()));
-    tokenNode->append_attribute(placeAttribute);
-    auto str = printDouble(token.getAge(), options.getSMCNumericPrecision());
-    xml_attribute<> *ageAttribute = doc.allocate_attribute("age", doc.allocate_string(
-            str.c_str()));
-    tokenNode->append_attribute(ageAttribute);
-    return tokenNode;
+void SMCVerification::printToken(Util::XMLTraceWriter &writer, const TAPN::TimedPlace &place, double age) {
+    writer.startElement("token");
+    writer.attribute("place", place.getName());
+    writer.attribute("age", printDouble(age, options.getSMCNumericPrecision()));
+    writer.endElement();
 }
 
-}
\ No newline at end of file
+}
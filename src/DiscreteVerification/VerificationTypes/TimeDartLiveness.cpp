@@ -28,8 +28,14 @@ namespace VerifyTAPN { namespace DiscreteVerification {
                 ((LivenessDart *) waitingDart->parent->dart)->traceData->push_back(waitingDart);
             }
 
+            // Delays of the dart in which the query holds, the waiting value is never below lo
+            int lo = 0, hi = std::numeric_limits<int32_t>::max();
+            if (deadlockQuery) {
+                queryWindow(waitingDart->dart->getBase(), lo, hi);
+            }
+
             // Detect ability to delay forever
-            if (canDelayForever(waitingDart->dart->getBase())) {
+            if (hi == std::numeric_limits<int32_t>::max() && canDelayForever(waitingDart->dart->getBase())) {
                 auto *lm = new NonStrictMarkingBase(*waitingDart->dart->getBase());
                 lm->setGeneratedBy(waitingDart->dart->getBase()->getGeneratedBy());
                 // lastMarking = new TraceList(lm, waitingDart.upper);
@@ -71,7 +77,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
 
                 // Calculate start and end
                 int start = std::max(waitingDart->w, calculatedStart.first);
-                int end = std::min(passed - 1, calculatedStart.second);
+                int end = std::min(std::min(passed - 1, calculatedStart.second), hi);
                 if (start <= end) {
                     int stop = std::max(start, calculateStop(transition, waitingDart->dart->getBase()));
                     int finalStop = std::min(stop, end);
@@ -80,7 +86,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
                         Mpp.incrementAge(n);
                         int _end = n;
                         if (n == stop) {
-                            _end = calculatedStart.second;
+                            _end = std::min(calculatedStart.second, hi);
                         }
 
                         this->tmpupper = _end;
@@ -94,8 +100,9 @@ namespace VerifyTAPN { namespace DiscreteVerification {
                 }
             }
 
-            // Detect deadlock
-            if (maxCalculatedEnd < maxPossibleDelay(waitingDart->dart->getBase())) {
+            // Detect deadlock, the run ends there if the query still holds
+            int maxDelay = maxPossibleDelay(waitingDart->dart->getBase());
+            if (maxCalculatedEnd < maxDelay && maxDelay <= hi) {
                 //lastMarking = new TraceList(waitingDart.dart->getBase(), maxPossibleDelay(waitingDart.dart->getBase()));
                 lastMarking = waitingDart;
                 deadlock = true;
@@ -108,6 +115,9 @@ namespace VerifyTAPN { namespace DiscreteVerification {
 
 
     bool TimeDartLiveness::canDelayForever(NonStrictMarkingBase *marking) {
+        if (urgentEnabled(*marking)) {
+            return false;
+        }
         for (auto& p_iter : marking->getPlaceList()) {
             if (p_iter.place->getInvariant().getBound() < std::numeric_limits<int32_t>::max()) {
                 return false;
@@ -132,13 +142,15 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             return false;
         }
 
-        int youngest = marking->makeBase();
-
-        QueryVisitor<NonStrictMarkingBase> checker(*marking, tapn);
-        AST::BoolResult context;
+        int youngest = 0;
+        if (urgentEnabled(*marking)) {
+            start = 0;
+        } else {
+            youngest = marking->makeBase();
+        }
 
-        query->accept(checker, context);
-        if (context.value) {
+        int lo, hi;
+        if (queryWindow(marking, lo, hi) && lo <= youngest && youngest <= hi) {
             std::pair<LivenessDart *, bool> result = pwList->add(marking, youngest, parent, upper, start);
 
 
@@ -179,6 +191,53 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         return false;
     }
 
+    bool TimeDartLiveness::queryWindow(NonStrictMarkingBase *marking, int &lo, int &hi) {
+        lo = 0;
+        hi = std::numeric_limits<int32_t>::max();
+        if (!deadlockQuery) {
+            QueryVisitor<NonStrictMarkingBase> checker(*marking, tapn);
+            AST::BoolResult context;
+            query->accept(checker, context);
+            return context.value;
+        }
+
+        // past the max constant every delay gives the same marking
+        int maxDelay = std::min(maxPossibleDelay(marking), tapn.getMaxConstant() + 1);
+        int first = maxDelay + 1;
+        int low = 0, high = maxDelay;
+        while (low <= high) {
+            int mid = low + (high - low) / 2;
+            if (marking->canDeadlock(tapn, mid)) {
+                first = mid;
+                high = mid - 1;
+            } else {
+                low = mid + 1;
+            }
+        }
+
+        auto holds = [&](int delay) {
+            QueryVisitor<NonStrictMarkingBase> checker(*marking, tapn, delay);
+            AST::BoolResult context;
+            query->accept(checker, context);
+            return context.value;
+        };
+        bool live = first > 0 && holds(0);
+        bool dead = first <= maxDelay && holds(first);
+        if (live && !dead && first <= maxDelay) {
+            hi = first - 1;
+        } else if (dead && !live) {
+            lo = first;
+        }
+        return live || dead;
+    }
+
+    bool TimeDartLiveness::containsDeadlock(AST::Query *query) {
+        AST::BoolResult containsDeadlock;
+        DeadlockVisitor deadlockVisitor = DeadlockVisitor();
+        deadlockVisitor.visit(*query, containsDeadlock);
+        return containsDeadlock.value;
+    }
+
     void TimeDartLiveness::printStats() {
         std::cout << "  discovered markings:\t" << pwList->discoveredMarkings << std::endl;
         std::cout << "  explored markings:\t" << exploredMarkings << std::endl;
@@ -29,6 +29,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             if (options.getTrace() != VerificationOptions::NO_TRACE) {
                 this->tmpdart = ((ReachabilityTraceableDart *) &dart)->trace;
             }
+            int zeroTime = reduceAtZeroTime(dart.getBase(), dart.getWaiting(), passed - 1);
             for (auto* t : tapn.getTransitions()) {
                 auto &transition = *t;
                 auto calculatedStart = calculateStart(transition, dart.getBase());
@@ -37,6 +38,9 @@ namespace VerifyTAPN { namespace DiscreteVerification {
                 }
                 int start = std::max(dart.getWaiting(), calculatedStart.first);
                 int end = std::min(passed - 1, calculatedStart.second);
+                if (end == zeroTime && !isStubborn(transition)) {
+                    end--;
+                }
 
                 if (start <= end) {
 
@@ -84,7 +88,13 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             return false;
         }
 
-        int youngest = marking->makeBase();
+        int youngest = 0;
+        if (urgentEnabled(*marking)) {
+            start = 0;
+            maxDelay = 0;
+        } else {
+            youngest = marking->makeBase();
+        }
 
         if (pwList->add(marking, youngest, parent, upper, start)) {
 
@@ -116,6 +126,9 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         std::cout << "  discovered markings:\t" << pwList->discoveredMarkings << std::endl;
         std::cout << "  explored markings:\t" << exploredMarkings << std::endl;
         std::cout << "  stored markings:\t" << pwList->size() << std::endl;
+        if (stubbornSet) {
+            stubbornSet->print_stats(std::cout);
+        }
     }
 
     TimeDartReachabilitySearch::~TimeDartReachabilitySearch() = default;
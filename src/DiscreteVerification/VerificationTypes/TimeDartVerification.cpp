@@ -11,145 +11,129 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             allwaysEnabled(), successorGenerator(tapn, query) {
         loop = false;
         deadlock = false;
+        startArcs.resize(tapn.getTransitions().size());
         //Find the transitions which don't have input arcs
         for (auto* t : tapn.getTransitions()) {
+            auto &start = startArcs[t->getIndex()];
+            for (auto* arc : t->getInhibitorArcs()) {
+                start.inhibitors.emplace_back(arc->getInputPlace().getIndex(), arc->getWeight());
+            }
+            for (auto* arc : t->getPreset()) {
+                int lower = arc->getInterval().getLowerBound();
+                int upper = arc->getInterval().getUpperBound();
+                bool unbounded = upper == std::numeric_limits<int32_t>::max();
+                start.arcs.push_back({(uint32_t) arc->getInputPlace().getIndex(), (uint32_t) arc->getWeight(), lower,
+                                      upper, unbounded ? std::numeric_limits<int32_t>::max() : upper - lower,
+                                      unbounded});
+            }
+            for (auto* arc : t->getTransportArcs()) {
+                Util::interval arcGuard(arc->getInterval().getLowerBound(), arc->getInterval().getUpperBound());
+                Util::interval invGuard(0, arc->getDestination().getInvariant().getBound());
+                Util::interval arcInterval = Util::intersect(arcGuard, invGuard);
+                int range = -1;
+                if (arcInterval.upper() == std::numeric_limits<int32_t>::max()) {
+                    range = std::numeric_limits<int32_t>::max();
+                } else if (!arcInterval.empty()) {
+                    range = arcInterval.upper() - arcInterval.lower();
+                }
+                start.arcs.push_back({(uint32_t) arc->getSource().getIndex(), (uint32_t) arc->getWeight(),
+                                      arcInterval.lower(), arcInterval.upper(), range, false});
+            }
             if (t->getPreset().size() + t->getTransportArcs().size() == 0) {
                 allwaysEnabled.push_back(t);
             }
-            if (t->isUrgent()) { // no implementation for urgency in timedart engine yet
-                std::cout << "The TimeDart engine cannot handle urgent transitions" << std::endl;
-                std::exit(1);
+            if (t->isUrgent()) {
+                urgentTransitions.push_back(t);
             }
         }
         if(options.getPartialOrderReduction())
         {
-           std::cout << "TimeDarts and partial order reduction no supported" << std::endl;
-           std::exit(1);
+            stubbornSet = std::make_unique<StubbornSet>(tapn, query);
+            if (options.getQueryGuidedReduction())
+                stubbornSet->enable_query_guided(options.getKBound());
+            stubborn.resize(tapn.getTransitions().size());
         }
     }
 
     std::pair<int, int>
     TimeDartVerification::calculateStart(const TAPN::TimedTransition &transition, NonStrictMarkingBase *marking) {
-        std::vector<Util::interval<>> start;
-        Util::interval initial(0, std::numeric_limits<int32_t>::max());
-        start.push_back(initial);
-
-        if (transition.getNumberOfInputArcs() + transition.getNumberOfTransportArcs() == 0) { //always enabled
-            std::pair<int, int> p(0, maxPossibleDelay(marking));
-            return p;
-        }
+        const StartArcs &arcs = startArcs[transition.getIndex()];
 
         // Inhibitor arcs
-        for (auto* arc : transition.getInhibitorArcs()) {
-            if (marking->numberOfTokensInPlace(arc->getInputPlace().getIndex()) >= arc->getWeight()) {
+        for (auto& inhibitor : arcs.inhibitors) {
+            if (marking->numberOfTokensInPlace(inhibitor.first) >= (int) inhibitor.second) {
                 std::pair<int, int> p(-1, -1);
                 return p;
             }
         }
 
+        if (arcs.arcs.empty()) { //always enabled
+            std::pair<int, int> p(0, maxPossibleDelay(marking));
+            return p;
+        }
 
-        // Standard arcs
-        for (auto* arc : transition.getPreset()) {
-            std::vector<Util::interval<>> intervals;
-            int range;
-            if (arc->getInterval().getUpperBound() == std::numeric_limits<int32_t>::max()) {
-                range = std::numeric_limits<int32_t>::max();
-            } else {
-                range = arc->getInterval().getUpperBound() - arc->getInterval().getLowerBound();
-            }
-            int weight = arc->getWeight();
+        Util::small_interval_set<> start, intervals, next;
+        start.emplace_back(0, std::numeric_limits<int32_t>::max());
 
-            TokenList tokens = marking->getTokenList(arc->getInputPlace().getIndex());
-            if (tokens.size() == 0) {
+        // Standard and transport arcs
+        for (auto& arc : arcs.arcs) {
+            const TokenList &tokens = marking->getTokenList(arc.place);
+            if (tokens.empty()) {
                 std::pair<int, int> p(-1, -1);
                 return p;
             }
 
+            // The window i..j of the youngest tokens covering the weight moves to older tokens as i grows, so the
+            // delays it enables come in decreasing order; they are merged from the back into a sorted set.
+            intervals.clear();
+            int weight = arc.weight;
             unsigned int j = 0;
-            int numberOfTokensAvailable = tokens.at(j).getCount();
+            int numberOfTokensAvailable = tokens[j].getCount();
             for (unsigned int i = 0; i < tokens.size(); i++) {
                 if (numberOfTokensAvailable < weight) {
                     for (j++; j < tokens.size() && numberOfTokensAvailable < weight; j++) {
-                        numberOfTokensAvailable += tokens.at(j).getCount();
+                        numberOfTokensAvailable += tokens[j].getCount();
                     }
                     j--;
                 }
                 if (numberOfTokensAvailable >= weight &&
-                    tokens.at(j).getAge() - tokens.at(i).getAge() <= range) { //This span is interesting
-                    int low = arc->getInterval().getLowerBound() - tokens.at(i).getAge();
-                    int heigh = arc->getInterval().getUpperBound() - tokens.at(j).getAge();
-
-                    Util::interval element(low < 0 ? 0 : low,
-                                           arc->getInterval().getUpperBound() == std::numeric_limits<int32_t>::max() ? std::numeric_limits<int32_t>::max() : heigh);
-                    Util::setAdd(intervals, element);
+                    tokens[j].getAge() - tokens[i].getAge() <= arc.range) { //This span is interesting
+                    int low = std::max(0, arc.lower - tokens[i].getAge());
+                    int high = arc.unbounded ? std::numeric_limits<int32_t>::max() : arc.upper - tokens[j].getAge();
+                    if (low <= high) {
+                        intervals.emplace_back(low, high);
+                    }
                 }
-                numberOfTokensAvailable -= tokens.at(i).getCount();
+                numberOfTokensAvailable -= tokens[i].getCount();
             }
 
-            start = Util::setIntersection(start, intervals);
-        }
-
-        // Transport arcs
-        for (auto* arc : transition.getTransportArcs()) {
-            Util::interval arcGuard(arc->getInterval().getLowerBound(), arc->getInterval().getUpperBound());
-            Util::interval invGuard(0, arc->getDestination().getInvariant().getBound());
-
-            Util::interval arcInterval = Util::intersect(arcGuard, invGuard);
-            std::vector<Util::interval<>> intervals;
-            int range;
-            if (arcInterval.upper() == std::numeric_limits<int32_t>::max()) {
-                range = std::numeric_limits<int32_t>::max();
-            } else {
-                range = arcInterval.upper() - arcInterval.lower();
+            next.clear();
+            for (auto it = intervals.rbegin(); it != intervals.rend(); ++it) {
+                if (!next.empty() && it->lower() <= next.back().upper()) {
+                    next.back().high = std::max(next.back().high, it->upper());
+                } else {
+                    next.push_back(*it);
+                }
             }
-            int weight = arc->getWeight();
-
-            TokenList tokens = marking->getTokenList(arc->getSource().getIndex());
-
-            if (tokens.size() == 0) {
+            Util::setIntersectionOf(start, next, intervals);
+            if (intervals.empty()) {
                 std::pair<int, int> p(-1, -1);
                 return p;
             }
-
-            unsigned int j = 0;
-            int numberOfTokensAvailable = tokens.at(j).getCount();
-            for (unsigned int i = 0; i < tokens.size(); i++) {
-                if (numberOfTokensAvailable < weight) {
-                    for (j++; j < tokens.size() && numberOfTokensAvailable < weight; j++) {
-                        numberOfTokensAvailable += tokens.at(j).getCount();
-                    }
-                    j--;
-                }
-                if (numberOfTokensAvailable >= weight &&
-                    tokens.at(j).getAge() - tokens.at(i).getAge() <= range) { //This span is interesting
-                    Util::interval element(arcInterval.lower() - tokens.at(i).getAge(),
-                                           arcInterval.upper() - tokens.at(j).getAge());
-                    Util::setAdd(intervals, element);
-                }
-                numberOfTokensAvailable -= tokens.at(i).getCount();
-            }
-
-            start = Util::setIntersection(start, intervals);
+            std::swap(start, intervals);
         }
 
         int invariantPart = maxPossibleDelay(marking);
-
-        std::vector<Util::interval<>> invEnd;
-        Util::interval initialInv(0, invariantPart);
-        invEnd.push_back(initialInv);
-        start = Util::setIntersection(start, invEnd);
-
-#if DEBUG
-        std::cout << "Intervals in start: " << start.size() << std::endl;
-#endif
-
-        if (start.empty()) {
+        if (start.front().lower() > invariantPart) {
             std::pair<int, int> p(-1, -1);
             return p;
-        } else {
-            std::pair<int, int> p(start.front().lower(), start.back().upper());
-            return p;
         }
+        auto last = start.end() - 1;
+        while (last->lower() > invariantPart) {
+            --last;
+        }
+        std::pair<int, int> p(start.front().lower(), std::min(last->upper(), invariantPart));
+        return p;
     }
 
     int
@@ -172,6 +156,10 @@ namespace VerifyTAPN { namespace DiscreteVerification {
     }
 
     int TimeDartVerification::maxPossibleDelay(NonStrictMarkingBase *marking) {
+        if (urgentEnabled(*marking)) {
+            return 0;
+        }
+
         int invariantPart = std::numeric_limits<int32_t>::max();
 
         for (auto& iter : marking->getPlaceList()) {
@@ -184,6 +172,56 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         return invariantPart;
     }
 
+    int TimeDartVerification::reduceAtZeroTime(NonStrictMarkingBase *base, int from, int to) {
+        if (!stubbornSet) {
+            return -1;
+        }
+        int maxDelay = maxPossibleDelay(base);
+        if (maxDelay == std::numeric_limits<int32_t>::max() || maxDelay < from || maxDelay > to) {
+            return -1;
+        }
+
+        NonStrictMarkingBase marking(*base);
+        marking.incrementAge(maxDelay);
+        stubbornSet->prepare(&marking);
+        if (stubbornSet->irreducable()) {
+            return -1;
+        }
+        std::fill(stubborn.begin(), stubborn.end(), false);
+        while (auto* transition = stubbornSet->pop_next()) {
+            stubborn[transition->getIndex()] = true;
+        }
+        return maxDelay;
+    }
+
+    bool TimeDartVerification::urgentEnabled(const NonStrictMarkingBase &marking) const {
+        for (auto *transition : urgentTransitions) {
+            bool enabled = true;
+            for (auto *arc : transition->getPreset()) {
+                if (marking.numberOfTokensInPlace(arc->getInputPlace().getIndex()) < arc->getWeight()) {
+                    enabled = false;
+                    break;
+                }
+            }
+            for (auto *arc : transition->getTransportArcs()) {
+                if (!enabled) break;
+                if (marking.numberOfTokensInPlace(arc->getSource().getIndex()) < arc->getWeight()) {
+                    enabled = false;
+                }
+            }
+            for (auto *arc : transition->getInhibitorArcs()) {
+                if (!enabled) break;
+                if (marking.numberOfTokensInPlace(arc->getInputPlace().getIndex()) >= arc->getWeight()) {
+                    enabled = false;
+                }
+            }
+            if (enabled) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     bool TimeDartVerification::generateAndInsertSuccessors(NonStrictMarkingBase &marking,
                                                            const TAPN::TimedTransition &transition) {
         successorGenerator.prepare(&marking);
@@ -7,6 +7,7 @@
 
 #include "DiscreteVerification/VerificationTypes/WorkflowSoundness.hpp"
 #include <limits>
+#include <thread>
 #include <utility>
 
 namespace VerifyTAPN { namespace DiscreteVerification {
@@ -14,17 +15,17 @@ namespace VerifyTAPN { namespace DiscreteVerification {
     WorkflowSoundness::WorkflowSoundness(TAPN::TimedArcPetriNet &tapn, NonStrictMarking &initialMarking,
                                          AST::Query *query, VerificationOptions options,
                                          WaitingList<NonStrictMarking *> *waiting_list)
-            : Workflow(tapn, initialMarking, query, std::move(options)), passedStack(), minExec(std::numeric_limits<int32_t>::max()),
-              linearSweepTreshold(3), coveredMarking(nullptr), modelType(calculateModelType()) {
-        pwList = new WorkflowPWList(waiting_list);
+            : Workflow(tapn, initialMarking, query, std::move(options)), minExec(std::numeric_limits<int32_t>::max()),
+              coveredMarking(nullptr), modelType(calculateModelType()) {
+        pwList = new WorkflowPWList(waiting_list, modelType == MTAWFN);
 
     }
 
 
     WorkflowSoundness::WorkflowSoundness(TAPN::TimedArcPetriNet &tapn, NonStrictMarking &initialMarking,
                                          AST::Query *query, VerificationOptions options)
-            : Workflow(tapn, initialMarking, query, std::move(options)), passedStack(), minExec(std::numeric_limits<int32_t>::max()),
-              linearSweepTreshold(3), coveredMarking(nullptr), modelType(calculateModelType()) {
+            : Workflow(tapn, initialMarking, query, std::move(options)), minExec(std::numeric_limits<int32_t>::max()),
+              coveredMarking(nullptr), modelType(calculateModelType()) {
 
     }
 
@@ -37,7 +38,8 @@ namespace VerifyTAPN { namespace DiscreteVerification {
                                           waiting_list,
                                           kbound,
                                           tapn.getNumberOfPlaces(),
-                                          tapn.getMaxConstant());
+                                          tapn.getMaxConstant(),
+                                          modelType == MTAWFN);
 
     }
 
@@ -86,32 +88,12 @@ namespace VerifyTAPN { namespace DiscreteVerification {
     }
 
     int WorkflowSoundness::numberOfPassed() {
-        int passed = 0;
-        while (passedStack.size()) {
-            WorkflowSoundnessMetaData *next =
-                    static_cast<WorkflowSoundnessMetaData *>(passedStack.top());
-            passedStack.pop();
-            if (next->passed) continue;
-            next->passed = true;
-            ++passed;
-            for (MetaData* m : next->parents)
-                passedStack.push(m);
-        }
-        return passed;
-    }
-
-    int WorkflowSoundnessPTrie::numberOfPassed() {
-        int passed = 0;
-        while (passedStack.size()) {
-            WorkflowSoundnessMetaDataWithEncoding *next =
-                    static_cast<WorkflowSoundnessMetaDataWithEncoding *>(passedStack.top());
-
-            passedStack.pop();
-            if (next->passed) continue;
-            next->passed = true;
-            ++passed;
-            for (MetaData* m : next->parents)
-                passedStack.push(m);
+        // mark the states that can reach a final marking, following the edges backwards
+        size_t threads = options.getThreads() > 0 ? options.getThreads() : std::thread::hardware_concurrency();
+        std::vector<bool> reached;
+        size_t passed = reverseEdges.backwardReachable(states.size(), finalStates, threads, reached);
+        for (size_t s = 0; s < states.size(); ++s) {
+            if (reached[s]) states[s]->passed = true;
         }
         return passed;
     }
@@ -134,17 +116,21 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         // Map to existing marking if any
         bool isNew = false;
         marking->setParent(parent);
-        NonStrictMarking *old = pwList->addToPassed(marking, false);
+        NonStrictMarking *old = pwList->addToPassed(marking);
         if (old == nullptr) {
             isNew = true;
         } else {
             delete marking;
             marking = old;
         }
+        if (isNew) {
+            stateId(marking->meta) = states.size();
+            states.push_back(marking->meta);
+        }
 
         // add to parents_set
         if (parent != nullptr) {
-            addParentMeta(marking->meta, parent->meta);
+            reverseEdges.addEdge(stateId(parent->meta), stateId(marking->meta));
             if (marking->getGeneratedBy() == nullptr) {
                 marking->meta->totalDelay = std::min(marking->meta->totalDelay,
                                                 parent->meta->totalDelay + 1);    // Delay
@@ -161,7 +147,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         // Test if final place
         if (marking->numberOfTokensInPlace(out->getIndex()) > 0) {
             if (size == 1) {
-                passedStack.push(marking->meta);
+                finalStates.push_back(stateId(marking->meta));
                 // Set min
                 marking->meta->totalDelay = std::min(marking->meta->totalDelay,
                                                 parent->meta->totalDelay);    // Transition
@@ -198,18 +184,12 @@ namespace VerifyTAPN { namespace DiscreteVerification {
         return false;
     }
 
-    void WorkflowSoundness::addParentMeta(MetaData *meta, MetaData *parent) {
-        WorkflowSoundnessMetaData *markingmeta = ((WorkflowSoundnessMetaData *) meta);
-        markingmeta->parents.push_back(parent);
-
+    uint32_t &WorkflowSoundness::stateId(MetaData *meta) {
+        return static_cast<WorkflowSoundnessMetaData *>(meta)->id;
     }
 
-    void WorkflowSoundnessPTrie::addParentMeta(MetaData *meta, MetaData *parent) {
-        assert(meta != nullptr);
-        assert(parent != nullptr);
-        WorkflowSoundnessMetaDataWithEncoding *markingmeta = ((WorkflowSoundnessMetaDataWithEncoding *) meta);
-        markingmeta->parents.push_back(parent);
-
+    uint32_t &WorkflowSoundnessPTrie::stateId(MetaData *meta) {
+        return static_cast<WorkflowSoundnessMetaDataWithEncoding *>(meta)->id;
     }
 
     bool WorkflowSoundness::checkForCoveredMarking(NonStrictMarking *marking) {
@@ -217,7 +197,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             return false;    // Do not run check on small markings (invoke more rarely)
         }
 
-        NonStrictMarking *covered = pwList->getCoveredMarking(marking, (marking->size() > linearSweepTreshold));
+        NonStrictMarking *covered = pwList->getCoveredMarking(marking);
         if (covered != nullptr) {
             coveredMarking = covered;
             return true;
@@ -7,6 +7,10 @@
 
 #include "DiscreteVerification/VerificationTypes/WorkflowStrongSoundness.hpp"
 
+#include <cassert>
+#include <limits>
+#include <queue>
+#include <unordered_map>
 #include <utility>
 
 namespace VerifyTAPN { namespace DiscreteVerification {
@@ -17,7 +21,7 @@ namespace VerifyTAPN { namespace DiscreteVerification {
                                                                              VerificationOptions options,
                                                                              WaitingList<NonStrictMarking *> *waiting_list)
             : Workflow(tapn, initialMarking, query, std::move(options)), maxValue(-1), outPlace(nullptr) {
-        pwList = new WorkflowPWList(waiting_list);
+        pwList = new WorkflowPWList(waiting_list, false);
         findInOut();
     }
 
@@ -53,7 +57,8 @@ namespace VerifyTAPN { namespace DiscreteVerification {
                                           waiting_list,
                                           options.getKBound(),
                                           tapn.getNumberOfPlaces(),
-                                          tapn.getMaxConstant());
+                                          tapn.getMaxConstant(),
+                                          false);
     }
 
     bool WorkflowStrongSoundnessReachability::run() {
@@ -63,141 +68,228 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             return true;
         }
 
-        if (handleSuccessor(&initialMarking, nullptr)) {
-            return true;
-        }
+        handleSuccessor(&initialMarking, nullptr);
 
-        //Main loop
+        // Explore every marking once, recording the edges between them
         while (pwList->hasWaitingStates()) {
-            NonStrictMarking *next_marking =
-                    static_cast<NonStrictMarking *>(pwList->getNextUnexplored());
+            NonStrictMarking *next_marking = pwList->getNextUnexplored();
             tmpParent = next_marking;
-
-            // push onto trace
-            trace.push(next_marking);
-            next_marking->meta->inTrace = true;
-            validChildren = 0;
+            uint32_t current = stateId(next_marking->meta);
+            edgeBegin[current] = edges.size();
 
             bool noDelay = false;
             auto res = generateAndInsertSuccessors(*next_marking);
-            if (res == ADDTOPW_RETURNED_TRUE) {
-                clearTrace();
-                return true;
-            } else if (res == ADDTOPW_RETURNED_FALSE_URGENTENABLED) {
+            if (res == ADDTOPW_RETURNED_FALSE_URGENTENABLED) {
                 noDelay = true;
             }
 
             // Generate delays markings
             if (!noDelay && isDelayPossible(*next_marking)) {
-                NonStrictMarking *marking = new NonStrictMarking(*next_marking);
+                auto *marking = new NonStrictMarking(*next_marking);
                 marking->incrementAge();
                 marking->setGeneratedBy(nullptr);
+                handleSuccessor(marking, next_marking);
+            }
+            edgeEnd[current] = edges.size();
+            deleteMarking(next_marking);
+        }
 
-                if (handleSuccessor(marking, next_marking)) {
-                    clearTrace();
-                    lastMarking = marking;
-                    return true;
+        return analyse();
+    }
+
+    bool WorkflowStrongSoundnessReachability::analyse() {
+        const uint32_t none = std::numeric_limits<uint32_t>::max();
+        const auto states = (uint32_t) terminal.size();
+
+        // Tarjan, iteratively; components are numbered in reverse topological order
+        std::vector<uint32_t> index(states, none);
+        std::vector<uint32_t> low(states);
+        std::vector<uint32_t> stack;
+        std::vector<std::pair<uint32_t, size_t> > calls;   // state and its next edge
+        component.assign(states, none);
+        uint32_t counter = 0;
+        uint32_t components = 0;
+
+        auto visit = [&](uint32_t state) {
+            index[state] = low[state] = counter++;
+            stack.push_back(state);
+            calls.emplace_back(state, edgeBegin[state]);
+        };
+
+        visit(0);
+        while (!calls.empty()) {
+            uint32_t state = calls.back().first;
+            size_t &e = calls.back().second;
+            if (e < edgeEnd[state]) {
+                uint32_t target = edges[e++].target;
+                if (index[target] == none) {
+                    visit(target);
+                } else if (component[target] == none) {
+                    low[state] = std::min(low[state], index[target]);
                 }
+                continue;
+            }
+            calls.pop_back();
+            if (!calls.empty()) {
+                uint32_t caller = calls.back().first;
+                low[caller] = std::min(low[caller], low[state]);
+            }
+            if (low[state] == index[state]) {
+                uint32_t member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    component[member] = components;
+                } while (member != state);
+                ++components;
+            }
+        }
 
+        // Group the states by component
+        componentBegin.assign(components + 1, 0);
+        for (uint32_t s = 0; s < states; ++s) {
+            ++componentBegin[component[s] + 1];
+        }
+        for (uint32_t c = 0; c < components; ++c) {
+            componentBegin[c + 1] += componentBegin[c];
+        }
+        members.resize(states);
+        {
+            std::vector<uint32_t> next(componentBegin.begin(), componentBegin.end() - 1);
+            for (uint32_t s = 0; s < states; ++s) {
+                members[next[component[s]]++] = s;
             }
-            if (validChildren != 0) {
-                next_marking->setNumberOfChildren(validChildren);
-            } else {
-                // remove childless markings from stack
-                while (!trace.empty() && trace.top()->getNumberOfChildren() <= 1) {
-                    trace.top()->meta->inTrace = false;
-                    deleteMarking(trace.top());
-                    trace.pop();
-                }
-                if (trace.empty()) {
-                    // this should only happen when the waitinglist is empty
-                    return false;
+        }
+
+        // Longest delay to each component, and the edge it is reached by
+        std::vector<int> delay(components, -1);
+        reachedBy.resize(components);
+        delay[component[0]] = 0;
+        for (uint32_t c = components; c-- > 0;) {
+            for (uint32_t i = componentBegin[c]; i < componentBegin[c + 1]; ++i) {
+                uint32_t s = members[i];
+                for (size_t e = edgeBegin[s]; e < edgeEnd[s]; ++e) {
+                    uint32_t target = component[edges[e].target];
+                    int weight = edges[e].transition < 0 ? 1 : 0;
+                    if (target == c) {
+                        if (weight == 0) continue;
+                        // time diverges on a cycle through this delay
+                        maxValue = delay[c] + 1;
+                        if (options.getTrace() != VerificationOptions::NO_TRACE) {
+                            std::vector<std::pair<uint32_t, int32_t> > path;
+                            pathTo(edges[e].target, path);
+                            pathInComponent(edges[e].target, s, path);
+                            path.emplace_back(edges[e].target, -1);
+                            makeTrace(path);
+                            lastMarking->setNumberOfChildren(1);    // make sure we can print trace
+                        }
+                        return true;
+                    }
+                    if (delay[c] + weight > delay[target]) {
+                        delay[target] = delay[c] + weight;
+                        reachedBy[target] = std::make_pair(s, e);
+                    }
                 }
-                trace.top()->decrementNumberOfChildren();
             }
         }
-        // should never reach here
-        assert(false);
-        return false;
-    }
 
-    void WorkflowStrongSoundnessReachability::getTrace() {
-        std::stack<NonStrictMarking *> printStack;
-        NonStrictMarking *next = lastMarking;
-        do {
-            auto *parent = (NonStrictMarking *) next->getParent();
-            printStack.push(next);
-            next = parent;
-
-        } while (next != nullptr && next->getParent() != nullptr);
+        uint32_t last = 0;
+        maxValue = -1;
+        for (uint32_t s = 0; s < states; ++s) {
+            if (terminal[s] && delay[component[s]] > maxValue) {
+                maxValue = delay[component[s]];
+                last = s;
+            }
+        }
+        bool bounded = true;
+        for (uint32_t s = 0; s < states; ++s) {
+            if (delay[component[s]] > options.getWorkflowBound()) {
+                bounded = false;
+                last = s;
+                break;
+            }
+        }
 
-        if (next != nullptr && printStack.top() != next) {
-            printStack.push(next);
+        if ((maxValue >= 0 || !bounded) && options.getTrace() != VerificationOptions::NO_TRACE) {
+            std::vector<std::pair<uint32_t, int32_t> > path;
+            pathTo(last, path);
+            makeTrace(path);
         }
+        return !bounded;
+    }
 
-        printXMLTrace(lastMarking, printStack, query, tapn);
+    void WorkflowStrongSoundnessReachability::pathTo(uint32_t state, std::vector<std::pair<uint32_t, int32_t> > &path) {
+        // walk back over the edges the longest delays were found by, then fill in the paths inside the components
+        std::vector<std::vector<std::pair<uint32_t, int32_t> > > segments;
+        uint32_t to = state;
+        while (component[to] != component[0]) {
+            const auto &via = reachedBy[component[to]];
+            const Edge &edge = edges[via.second];
+            segments.emplace_back(1, std::make_pair(edge.target, edge.transition));
+            pathInComponent(edge.target, to, segments.back());
+            to = via.first;
+        }
+        path.emplace_back(0, -1);
+        pathInComponent(0, to, path);
+        for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+            path.insert(path.end(), it->begin(), it->end());
+        }
     }
 
-    void WorkflowStrongSoundnessPTrie::getTrace() {
+    void WorkflowStrongSoundnessReachability::pathInComponent(uint32_t from, uint32_t to,
+                                                              std::vector<std::pair<uint32_t, int32_t> > &path) {
+        if (from == to) return;
+        // breadth first inside the component, remembering the edge each state was found by
+        std::unordered_map<uint32_t, std::pair<uint32_t, size_t> > foundBy;
+        std::queue<uint32_t> queue;
+        queue.push(from);
+        foundBy[from] = std::make_pair(from, 0);
+        while (foundBy.count(to) == 0) {
+            assert(!queue.empty());
+            uint32_t state = queue.front();
+            queue.pop();
+            for (size_t e = edgeBegin[state]; e < edgeEnd[state]; ++e) {
+                uint32_t target = edges[e].target;
+                if (component[target] == component[from] && foundBy.count(target) == 0) {
+                    foundBy[target] = std::make_pair(state, e);
+                    queue.push(target);
+                }
+            }
+        }
+        size_t size = path.size();
+        for (uint32_t state = to; state != from; state = foundBy[state].first) {
+            path.emplace_back(state, edges[foundBy[state].second].transition);
+        }
+        std::reverse(path.begin() + size, path.end());
+    }
 
-        PWListHybrid *pwhlist = dynamic_cast<PWListHybrid *>(this->pwList);
+    void WorkflowStrongSoundnessReachability::makeTrace(const std::vector<std::pair<uint32_t, int32_t> > &path) {
+        NonStrictMarking *previous = nullptr;
+        for (const auto &step : path) {
+            NonStrictMarking *marking = copyOfState(step.first);
+            marking->setParent(previous);
+            marking->setGeneratedBy(step.second < 0 ? nullptr : tapn.getTransitions()[step.second]);
+            if (previous != nullptr) traceMarkings.push_back(previous);
+            previous = marking;
+        }
+        lastMarking = previous;
+    }
 
+    void WorkflowStrongSoundnessReachability::getTrace() {
         std::stack<NonStrictMarking *> printStack;
-
         NonStrictMarking *next = lastMarking;
-        if (next != nullptr) {
-
+        while (next != nullptr) {
             printStack.push(next);
-            auto *meta =
-                    static_cast<MetaDataWithTraceAndEncoding *>(next->meta);
-
-            if (meta == nullptr) {
-                // We assume the parent was not deleted on return
-                NonStrictMarking *parent = (NonStrictMarking *) lastMarking->getParent();
-                if (parent != nullptr)
-                    meta =
-                            static_cast<MetaDataWithTraceAndEncoding *>(parent->meta);
-                delete parent;
-            } else {
-                meta = meta->parent;
-            }
-
-            while (meta != nullptr) {
-                next = pwhlist->decode(meta->ep);
-                next->setGeneratedBy(meta->generatedBy);
-                printStack.top()->setParent(next);
-                printStack.push(next);
-                meta = meta->parent;
-            }
+            next = (NonStrictMarking *) next->getParent();
         }
-#ifdef CLEANUP
-        std::stack < NonStrictMarking*> cleanup = printStack;
-#endif
-        printXMLTrace(lastMarking, printStack, query, tapn);
 
-#ifdef CLEANUP
-        while(!cleanup.empty())
-        {
-            if(cleanup.top() != lastMarking) // deleted elsewhere
-            {
-                delete cleanup.top();
-                cleanup.pop();
-            }
-            else
-            {
-                break;
-            }
-        }
-#endif
+        printXMLTrace(lastMarking, printStack, query, tapn);
     }
 
-
     bool WorkflowStrongSoundnessReachability::handleSuccessor(NonStrictMarking *marking, NonStrictMarking *parent) {
         marking->cut(placeStats);
         marking->setParent(parent);
 
-        int totalDelay = marking->calculateTotalDelay();
-
         unsigned int size = marking->size();
 
         pwList->setMaxNumTokensIfGreater(size);
@@ -207,81 +299,59 @@ namespace VerifyTAPN { namespace DiscreteVerification {
             return false;
         }
 
-        /* Handle max */
-        // Map to existing marking if any
-        NonStrictMarking *old = (NonStrictMarking *) pwList->addToPassed(marking, true);
+        int32_t transition = marking->getGeneratedBy() == nullptr ? -1 : (int32_t) marking->getGeneratedBy()->getIndex();
 
+        // Map to existing marking if any
+        NonStrictMarking *old = pwList->addToPassed(marking);
+        uint32_t state;
         if (old != nullptr) {
-            if (old->meta->totalDelay < totalDelay) {
-                if (old->meta->inTrace) {
-                    // delay loop
-                    lastMarking = marking;
-                    // make sure we can print trace
-                    marking->setNumberOfChildren(1);
-                    maxValue = totalDelay;
-                    deleteMarking(old);
-                    return true;
-                } else {
-                    // search again to find maxdelay
-                    swapData(marking, old);
-                    old->meta->totalDelay = totalDelay;
-                    delete marking;
-                    marking = old;
-                    // fall through on purpose
-                }
-            } else {
-                deleteMarking(old);
-                delete marking;
-                // already seen this maxage/marking combination
-                return false;
-            }
+            state = stateId(old->meta);
+            deleteMarking(old);
+            delete marking;
         } else {
-            marking->meta->totalDelay = totalDelay;
+            state = (uint32_t) terminal.size();
+            stateId(marking->meta) = state;
+            addState(marking);
+            bool isTerminal = marking->numberOfTokensInPlace(outPlace->getIndex()) > 0;
+            terminal.push_back(isTerminal);
+            edgeBegin.push_back(0);
+            edgeEnd.push_back(0);
+            // final markings are not explored further
+            if (!isTerminal) {
+                pwList->addLastToWaiting();
+            }
+            deleteMarking(marking);
         }
 
-        // if we reached bound
-        if (marking->meta->totalDelay > options.getWorkflowBound()) return true;
-
-
-        if (marking->numberOfTokensInPlace(outPlace->getIndex()) == 0) {
-            // if nonterminal, add to waiting
-            pwList->addLastToWaiting();
-            ++validChildren;
-        } else {
-            // if terminal, update max_value and last marking of trace
-            if (maxValue < marking->meta->totalDelay) {
-                maxValue = marking->meta->totalDelay;
-                if (lastMarking != nullptr) deleteMarking(lastMarking);
-                lastMarking = marking;
-                return false;
-            }
+        if (parent != nullptr) {
+            edges.push_back(Edge{state, transition});
         }
+        return false;
+    }
 
-        deleteMarking(marking);
+    uint32_t &WorkflowStrongSoundnessReachability::stateId(MetaData *meta) {
+        return static_cast<WorkflowSoundnessMetaData *>(meta)->id;
+    }
 
-        return false;
+    void WorkflowStrongSoundnessReachability::addState(NonStrictMarking *marking) {
+        markings.push_back(marking);
     }
 
-    void WorkflowStrongSoundnessReachability::swapData(NonStrictMarking *marking, NonStrictMarking *old) {
-        old->setGeneratedBy(marking->getGeneratedBy());
-        old->setParent(marking->getParent());
+    NonStrictMarking *WorkflowStrongSoundnessReachability::copyOfState(uint32_t state) {
+        return new NonStrictMarking(*markings[state]);
     }
 
-    void WorkflowStrongSoundnessPTrie::swapData(NonStrictMarking *marking, NonStrictMarking *parent) {
-        PWListHybrid *pwhlist = dynamic_cast<PWListHybrid *>(this->pwList);
-        auto *meta =
-                static_cast<MetaDataWithTraceAndEncoding *>(parent->meta);
+    uint32_t &WorkflowStrongSoundnessPTrie::stateId(MetaData *meta) {
+        return static_cast<WorkflowSoundnessMetaDataWithEncoding *>(meta)->id;
+    }
 
-        meta->generatedBy = marking->getGeneratedBy();
-        meta->parent = pwhlist->parent;
+    void WorkflowStrongSoundnessPTrie::addState(NonStrictMarking *marking) {
+        metas.push_back(static_cast<MetaDataWithTraceAndEncoding *>(marking->meta));
     }
 
-    void WorkflowStrongSoundnessPTrie::clearTrace() {
-        if (!trace.empty()) trace.pop(); // pop parent, used in getTrace
-        while (!trace.empty()) {
-            delete trace.top();
-            trace.pop();
-        }
+    NonStrictMarking *WorkflowStrongSoundnessPTrie::copyOfState(uint32_t state) {
+        auto *pwhlist = dynamic_cast<PWListHybrid *>(this->pwList);
+        return pwhlist->decode(metas[state]->ep);
     }
 
 } } /* namespace VerifyTAPN */
@@ -45,28 +45,14 @@ int main(int argc, char *argv[]) {
         std::cout << output_stream.get()->str();
     }
     
-    std::unique_ptr<AST::Query> query = make_query(builder, options, *tapn);
-    assert(query);
-
-
-    if(options.getSearchType() == VerificationOptions::OverApprox)
-    {
-        std::cout << "Verification-mode is OverApprox, terminating, no more to do!" << std::endl;
-        return 0;
+    if (options.getWorkflowMode() == VerificationOptions::NOT_WORKFLOW && options.getQueryNumbers().size() > 1) {
+        return verify_queries(builder, options, *tapn, initialPlacement);
     }
 
-    if (tapn->containsOrphanTransitions()) {
-        std::cout << "The model contains orphan transitions. This is not supported by the engine." << std::endl;
-        return 1;
-    }
-
-    if (query->getQuantifier() == AST::CF || query->getQuantifier() == AST::CG) {
-        options.setKeepDeadTokens(true);
-    }
-
-    tapn->updatePlaceTypes(query.get(), options);
+    std::unique_ptr<AST::Query> query = make_query(builder, options, *tapn);
+    assert(query);
 
-    int result = DiscreteVerification::DiscreteVerification::run(*tapn, initialPlacement, query.get(), options);
+    int result = verify_query(*tapn, initialPlacement, query.get(), options);
 
     return result;
 }
@@ -1,20 +1,24 @@
+#include "verifydtapn.h"
 #include <iostream>
 #include <fstream>
 #include "Core/TAPN/TAPNModelBuilder.hpp"
 #include "Core/VerificationOptions.hpp"
 #include "Core/TAPN/TimedPlace.hpp"
 #include "DiscreteVerification/DeadlockVisitor.hpp"
+#include "DiscreteVerification/DiscreteVerification.hpp"
 
 #include <unfoldtacpn.h>
 #include <Colored/ColoredPetriNetBuilder.h>
 #include <memory>
+#include <chrono>
 
 
 using namespace VerifyTAPN::TAPN;
 
 namespace VerifyTAPN {
 
-    std::unique_ptr<AST::Query> parse_queries(const VerificationOptions& options,
+    std::vector<std::pair<std::unique_ptr<AST::Query>, std::string>>
+    parse_query_list(const VerificationOptions& options,
         const unfoldtacpn::ColoredPetriNetBuilder& builder, const TimedArcPetriNet& net) {
         try {
             auto& queryFile = options.getQueryFile();
@@ -25,19 +29,20 @@ namespace VerifyTAPN {
             } else {
                 std::vector<std::pair < unfoldtacpn::PQL::Condition_ptr, std::string>> ast_queries;
                 auto qnums = options.getQueryNumbers();
-                size_t quid = 0;
+                std::vector<size_t> quids;
                 if (qfile.peek() == '<') { // assumed XML
                     if (qnums.empty()) {
                         std::cerr << "Missing query-indexes for query-file (which is identified as XML-format), assuming only first query is to be verified" << std::endl;
                         qnums.emplace(0);
                     }
-                    quid = *qnums.begin();
+                    quids.assign(qnums.begin(), qnums.end());
                     ast_queries = unfoldtacpn::parse_xml_queries(builder, qfile, qnums);
                 } else {
                     // not xml
                     if (qnums.size() > 0) {
                         std::cerr << "Queries not provided in XML-format, --xml-queries argument is ignored" << std::endl;
                     }
+                    quids.emplace_back(0);
                     ast_queries = unfoldtacpn::parse_string_queries(builder, qfile);
                 }
                 if (ast_queries.empty()) {
@@ -49,14 +54,29 @@ namespace VerifyTAPN {
                     std::fstream of(options.getOutputQueryFile(), std::ios::out);
                     unfoldtacpn::PQL::to_xml(of, ast_queries);
                 }
-                return std::unique_ptr<Query>(AST::toAST(ast_queries[quid].first, net));
+
+                std::vector<std::pair<std::unique_ptr<AST::Query>, std::string>> queries;
+                for (auto quid : quids) {
+                    if (quid >= ast_queries.size() || ast_queries[quid].first == nullptr) {
+                        std::cerr << "Query-index " << (quid + 1) << " does not exist in " << queryFile << std::endl;
+                        std::exit(-1);
+                    }
+                    queries.emplace_back(AST::toAST(ast_queries[quid].first, net), ast_queries[quid].second);
+                }
+                return queries;
             }
 
         } catch (...) {
             std::cout << "There was an error parsing the query file." << std::endl;
             std::exit(-1);
         }
-        return nullptr;
+        return {};
+    }
+
+    std::unique_ptr<AST::Query> parse_queries(const VerificationOptions& options,
+        const unfoldtacpn::ColoredPetriNetBuilder& builder, const TimedArcPetriNet& net) {
+        auto queries = parse_query_list(options, builder, net);
+        return std::move(queries.front().first);
     }
 
     std::pair<std::vector<int>, std::unique_ptr<TAPN::TimedArcPetriNet>>
@@ -104,27 +124,165 @@ namespace VerifyTAPN {
         } else {
             query = parse_queries(options, builder, net);
             assert(query);
-            if (options.getTrace() != VerificationOptions::NO_TRACE &&
-                (query->getQuantifier() == AST::CF || query->getQuantifier() == AST::CG)) {
-                std::cout << "Traces are not supported for game-synthesis" << std::endl;
+            check_query_options(*query, options);
+        }
+        return query;
+    }
+
+    void check_query_options(const AST::Query& query, VerificationOptions& options) {
+        if (options.getTrace() != VerificationOptions::NO_TRACE &&
+            (query.getQuantifier() == AST::CF || query.getQuantifier() == AST::CG)) {
+            std::cout << "Traces are not supported for game-synthesis" << std::endl;
+            std::exit(1);
+        }
+
+        if (options.getTrace() == VerificationOptions::FASTEST_TRACE &&
+            (options.getSearchType() != VerificationOptions::DEFAULT ||
+            query.getQuantifier() == AST::EG || query.getQuantifier() == AST::AF ||
+            options.getVerificationType() == VerificationOptions::TIMEDART)) {
+            std::cout
+                << "Fastest trace-option is only supported for reachability queries with default search strategy and without time darts."
+                << std::endl;
+            std::exit(1);
+        } else if (options.getTrace() == VerificationOptions::FASTEST_TRACE) {
+            options.setSearchType(VerificationOptions::MINDELAYFIRST);
+        } else if (options.getSearchType() == VerificationOptions::DEFAULT) {
+            options.setSearchType(VerificationOptions::COVERMOST);
+        }
+
+        if (!options.getStateSpaceCache().empty() &&
+            options.getVerificationType() == VerificationOptions::DISCRETE &&
+            (query.getQuantifier() == AST::EF || query.getQuantifier() == AST::AG)) {
+            if (options.getTrace() != VerificationOptions::NO_TRACE) {
+                std::cout << "Traces are not supported when using a state-space cache" << std::endl;
                 std::exit(1);
             }
+            // the cached state-space must not depend on the query
+            options.setKeepDeadTokens(true);
+            options.setPartialOrderReduction(false);
+        }
+    }
 
-            if (options.getTrace() == VerificationOptions::FASTEST_TRACE &&
-                (options.getSearchType() != VerificationOptions::DEFAULT ||
-                query->getQuantifier() == AST::EG || query->getQuantifier() == AST::AF ||
-                options.getVerificationType() == VerificationOptions::TIMEDART)) {
-                std::cout
-                    << "Fastest trace-option is only supported for reachability queries with default search strategy and without time darts."
-                    << std::endl;
-                std::exit(1);
-            } else if (options.getTrace() == VerificationOptions::FASTEST_TRACE) {
-                options.setSearchType(VerificationOptions::MINDELAYFIRST);
-            } else if (options.getSearchType() == VerificationOptions::DEFAULT) {
-                options.setSearchType(VerificationOptions::COVERMOST);
+    int verify_query(TAPN::TimedArcPetriNet& net, const std::vector<int>& initialPlacement,
+                     AST::Query* query, VerificationOptions& options) {
+        if (options.getSearchType() == VerificationOptions::OverApprox) {
+            std::cout << "Verification-mode is OverApprox, terminating, no more to do!" << std::endl;
+            return 0;
+        }
+
+        if (net.containsOrphanTransitions()) {
+            std::cout << "The model contains orphan transitions. This is not supported by the engine." << std::endl;
+            return 1;
+        }
+
+        if (query->getQuantifier() == AST::CF || query->getQuantifier() == AST::CG) {
+            options.setKeepDeadTokens(true);
+        }
+
+        net.updatePlaceTypes(query, options);
+
+        return DiscreteVerification::DiscreteVerification::run(net, initialPlacement, query, options);
+    }
+
+    // Only plain reachability queries without traces can be answered by a single exploration of the discrete
+    // state-space; everything else is verified on its own.
+    static bool can_share_exploration(const AST::Query& query, const VerificationOptions& options) {
+        return (query.getQuantifier() == AST::EF || query.getQuantifier() == AST::AG) &&
+               options.getVerificationType() == VerificationOptions::DISCRETE &&
+               options.getTrace() == VerificationOptions::NO_TRACE &&
+               options.getSearchType() != VerificationOptions::OverApprox &&
+               options.getStateSpaceCache().empty();
+    }
+
+    int verify_queries(const unfoldtacpn::ColoredPetriNetBuilder& builder, const VerificationOptions& options,
+                       TAPN::TimedArcPetriNet& net, const std::vector<int>& initialPlacement) {
+        auto queries = parse_query_list(options, builder, net);
+        std::vector<VerificationOptions> queryOptions(queries.size(), options);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            check_query_options(*queries[i].first, queryOptions[i]);
+            if (queries[i].first->getQuantifier() == AST::CF || queries[i].first->getQuantifier() == AST::CG) {
+                queryOptions[i].setKeepDeadTokens(true);
             }
         }
-        return query;
+
+        // Place-types are only ever lifted from dead to standard, so registering all queries before the
+        // first verification yields the same net for every query, regardless of the order they are run in.
+        for (size_t i = 0; i < queries.size(); ++i) {
+            net.updatePlaceTypes(queries[i].first.get(), queryOptions[i]);
+        }
+
+        int result = 0;
+        std::vector<bool> shared(queries.size(), false);
+        std::vector<size_t> sharedIndices;
+        double sharedDuration = 0;
+        if (options.getSharedExploration()) {
+            for (size_t i = 0; i < queries.size(); ++i) {
+                if (can_share_exploration(*queries[i].first, queryOptions[i])) {
+                    sharedIndices.push_back(i);
+                }
+            }
+            if (sharedIndices.size() < 2) {
+                sharedIndices.clear();
+            }
+        }
+
+        if (!sharedIndices.empty()) {
+            std::vector<AST::Query*> sharedQueries;
+            for (auto i : sharedIndices) {
+                sharedQueries.push_back(queries[i].first.get());
+                shared[i] = true;
+            }
+            std::cout << "Verifying " << sharedQueries.size() << " of " << queries.size()
+                      << " queries using a shared exploration" << std::endl;
+            VerificationOptions sharedOptions = queryOptions[sharedIndices.front()];
+            std::vector<bool> results;
+            auto start = std::chrono::steady_clock::now();
+            int res;
+            if (net.containsOrphanTransitions()) {
+                std::cout << "The model contains orphan transitions. This is not supported by the engine." << std::endl;
+                res = 1;
+            } else {
+                res = DiscreteVerification::DiscreteVerification::run(net, initialPlacement, sharedQueries,
+                                                                      sharedOptions, results);
+            }
+            auto stop = std::chrono::steady_clock::now();
+            sharedDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count() / 1.0E9;
+            for (size_t j = 0; j < results.size(); ++j) {
+                std::cout << "Query " << queries[sharedIndices[j]].second << " is "
+                          << (results[j] ? "satisfied" : "NOT satisfied") << "." << std::endl;
+            }
+            std::cout << "Shared exploration verification time: " << sharedDuration << "s"
+                      << std::endl << std::endl;
+            result = res;
+        }
+
+        std::vector<double> durations(queries.size(), 0);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            if (shared[i]) continue;
+            std::cout << "Verifying query " << (i + 1) << " of " << queries.size()
+                      << " (" << queries[i].second << ")" << std::endl;
+            auto start = std::chrono::steady_clock::now();
+            int res = verify_query(net, initialPlacement, queries[i].first.get(), queryOptions[i]);
+            auto stop = std::chrono::steady_clock::now();
+            durations[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count() / 1.0E9;
+            std::cout << "Query " << queries[i].second << " verification time: " << durations[i] << "s"
+                      << std::endl << std::endl;
+            if (result == 0) result = res;
+        }
+
+        std::cout << "Batch verification of " << queries.size() << " queries:" << std::endl;
+        double total = sharedDuration;
+        if (!sharedIndices.empty()) {
+            std::cout << "  shared exploration (" << sharedIndices.size() << " queries):\t" << sharedDuration << "s"
+                      << std::endl;
+        }
+        for (size_t i = 0; i < queries.size(); ++i) {
+            if (shared[i]) continue;
+            std::cout << "  " << queries[i].second << ":\t" << durations[i] << "s" << std::endl;
+            total += durations[i];
+        }
+        std::cout << "  total verification time:\t" << total << "s" << std::endl;
+        return result;
     }
 
 }
@@ -24,6 +24,13 @@
 
 #include "verifydtapn.h"
 #include "Core/TAPN/TAPNModelBuilder.hpp"
+#include "DiscreteVerification/DataStructures/WaitingList.hpp"
+#include "DiscreteVerification/Generators/ReducingGenerator.hpp"
+#include "DiscreteVerification/VerificationTypes/ReachabilitySearch.hpp"
+#include "DiscreteVerification/VerificationTypes/TimeDartReachabilitySearch.hpp"
+#include "DiscreteVerification/VerificationTypes/WorkflowStrongSoundness.hpp"
+
+#include <functional>
 
 
 using namespace VerifyTAPN;
@@ -84,3 +91,268 @@ BOOST_AUTO_TEST_CASE(inhib_guard)
     BOOST_REQUIRE_EQUAL(trans->getNumberOfTransportArcs(), 0);
 
 }
+
+// in -> start -> P -> end -> out, where end consumes from P within [lower, upper]. P has the given invariant,
+// in does not allow any delay.
+std::unique_ptr<TAPN::TimedArcPetriNet> workflow_net(TAPNModelBuilder& builder, int invariant, int lower, int upper)
+{
+    const int inf = std::numeric_limits<int>::max();
+    builder.addPlace("in", 1, false, 0);
+    builder.addPlace("P", 0, invariant == inf, invariant);
+    builder.addPlace("out", 0, true, inf);
+    builder.addTransition("start", 0, false, 0, 0);
+    builder.addInputArc("in", "start", false, 1, false, false, 0, 0);
+    builder.addOutputArc("start", "P", 1);
+    builder.addTransition("end", 0, false, 0, 0);
+    builder.addInputArc("P", "end", false, 1, false, upper == inf, lower, upper);
+    builder.addOutputArc("end", "out", 1);
+    std::unique_ptr<TAPN::TimedArcPetriNet> tapn(builder.make_tapn());
+    tapn->initialize(false, false);
+    return tapn;
+}
+
+struct StrongSoundnessResult {
+    bool violated;
+    std::string executionTime;
+    std::string trace;
+};
+
+StrongSoundnessResult strong_soundness(TAPN::TimedArcPetriNet& tapn, const std::vector<int>& initialPlacement,
+                                       bool ptrie, long long bound = 1000)
+{
+    using namespace VerifyTAPN::DiscreteVerification;
+    VerificationOptions options;
+    options.setKBound(3);
+    options.setWorkflowMode(VerificationOptions::WORKFLOW_STRONG_SOUNDNESS);
+    options.setWorkflowBound(bound);
+    options.setTrace(VerificationOptions::SOME_TRACE);
+    AST::Query query(AST::EF, new AST::BoolExpression(true));
+    tapn.updatePlaceTypes(&query, options);
+    // owned by the passed list once explored
+    auto* initialMarking = new NonStrictMarking(tapn, initialPlacement);
+    std::unique_ptr<WorkflowStrongSoundnessReachability> verifier;
+    if (ptrie) {
+        verifier = std::make_unique<WorkflowStrongSoundnessPTrie>(tapn, *initialMarking, &query, options,
+                                                                  new StackWaitingList<ptriepointer_t<MetaData*>>());
+    } else {
+        verifier = std::make_unique<WorkflowStrongSoundnessReachability>(tapn, *initialMarking, &query, options,
+                                                                         new StackWaitingList<NonStrictMarking*>());
+    }
+    StrongSoundnessResult result;
+    result.violated = verifier->run();
+    std::stringstream time;
+    verifier->printExecutionTime(time);
+    result.executionTime = time.str();
+    // traces are written to std::cerr
+    std::stringstream trace;
+    auto* cerr = std::cerr.rdbuf(trace.rdbuf());
+    verifier->getTrace();
+    std::cerr.rdbuf(cerr);
+    result.trace = trace.str();
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(strong_soundness_time_divergence)
+{
+    for (bool ptrie : {false, true}) {
+        TAPNModelBuilder builder;
+        auto tapn = workflow_net(builder, std::numeric_limits<int>::max(), 0, std::numeric_limits<int>::max());
+        auto result = strong_soundness(*tapn, builder.initialMarking(), ptrie);
+        BOOST_REQUIRE(result.violated);
+        // the token in P can age forever without ever firing end
+        BOOST_REQUIRE(result.trace.find("<transition id=\"start\"") != std::string::npos);
+        BOOST_REQUIRE(result.trace.find("<delay>forever</delay>") != std::string::npos);
+        BOOST_REQUIRE(result.trace.find("<transition id=\"end\"") == std::string::npos);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(strong_soundness_maximal_duration)
+{
+    for (bool ptrie : {false, true}) {
+        TAPNModelBuilder builder;
+        auto tapn = workflow_net(builder, 3, 2, 3);
+        auto result = strong_soundness(*tapn, builder.initialMarking(), ptrie);
+        BOOST_REQUIRE(!result.violated);
+        BOOST_REQUIRE_EQUAL(result.executionTime, "Maximum execution time: 3\n");
+        BOOST_REQUIRE(result.trace.find("<delay>3</delay>") != std::string::npos);
+        BOOST_REQUIRE(result.trace.find("<transition id=\"end\"") != std::string::npos);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(strong_soundness_bound_exceeded)
+{
+    for (bool ptrie : {false, true}) {
+        TAPNModelBuilder builder;
+        auto tapn = workflow_net(builder, 3, 2, 3);
+        auto result = strong_soundness(*tapn, builder.initialMarking(), ptrie, 2);
+        BOOST_REQUIRE(result.violated);
+        BOOST_REQUIRE(result.trace.find("<delay>3</delay>") != std::string::npos);
+    }
+}
+
+// Verdicts of one search without reduction, with partial order reduction and with query guided reduction
+struct ReductionVerdicts {
+    bool full, reduced, guided;
+};
+
+// Verdicts of the discrete and the time dart reachability search on a fresh net.
+// The net and query are rebuilt for every run, since updatePlaceTypes adapts the net to the query.
+std::vector<ReductionVerdicts> reachability(const std::function<void(TAPNModelBuilder&)>& net,
+                                            const std::function<AST::Query*()>& query)
+{
+    using namespace VerifyTAPN::DiscreteVerification;
+    std::vector<ReductionVerdicts> verdicts;
+    for (bool timeDarts : {false, true}) {
+        bool verdict[3];
+        for (int reduction = 0; reduction < 3; ++reduction) {
+            bool por = reduction > 0;
+            TAPNModelBuilder builder;
+            net(builder);
+            std::unique_ptr<TAPN::TimedArcPetriNet> tapn(builder.make_tapn());
+            tapn->initialize(false, false);
+            std::unique_ptr<AST::Query> q(query());
+            VerificationOptions options;
+            options.setKBound(6);
+            options.setPartialOrderReduction(por);
+            options.setQueryGuidedReduction(reduction == 2);
+            tapn->updatePlaceTypes(q.get(), options);
+            if (timeDarts) {
+                NonStrictMarkingBase initialMarking(*tapn, builder.initialMarking());
+                TimeDartReachabilitySearch search(*tapn, initialMarking, q.get(), options,
+                                                  new StackWaitingList<TimeDartBase*>());
+                verdict[reduction] = search.run();
+            } else {
+                NonStrictMarking initialMarking(*tapn, builder.initialMarking());
+                if (por) {
+                    ReachabilitySearch<ReducingGenerator> search(*tapn, initialMarking, q.get(), options,
+                                                                 new StackWaitingList<NonStrictMarking*>());
+                    verdict[reduction] = search.run();
+                } else {
+                    ReachabilitySearch<Generator> search(*tapn, initialMarking, q.get(), options,
+                                                         new StackWaitingList<NonStrictMarking*>());
+                    verdict[reduction] = search.run();
+                }
+            }
+        }
+        verdicts.push_back({verdict[0], verdict[1], verdict[2]});
+    }
+    return verdicts;
+}
+
+BOOST_AUTO_TEST_CASE(por_not_equal)
+{
+    // The reduction marked no transition as interesting for a != atom whose sides are equal when negated,
+    // and pruned the only way to P2 = 2.
+    const int inf = std::numeric_limits<int>::max();
+    auto net = [inf](TAPNModelBuilder& builder) {
+        for (const char* place : {"P0", "P1", "P2"}) {
+            builder.addPlace(place, 1, false, 4);
+        }
+        builder.addTransition("T0", 0, false, 0, 0);
+        builder.addInputArc("P2", "T0", false, 1, false, true, 1, inf);
+        builder.addOutputArc("T0", "P0", 1);
+        builder.addTransition("T1", 0, true, 0, 0);
+        builder.addInputArc("P2", "T1", false, 1, false, true, 0, inf);
+        builder.addInputArc("P1", "T1", false, 1, false, true, 0, inf);
+        builder.addOutputArc("T1", "P2", 1);
+        builder.addOutputArc("T1", "P1", 1);
+        builder.addTransition("T2", 0, false, 0, 0);
+        builder.addInputArc("P0", "T2", false, 1, false, false, 0, 0);
+        builder.addOutputArc("T2", "P2", 1);
+        builder.addTransition("T3", 0, false, 0, 0);
+        builder.addInputArc("P0", "T3", false, 1, false, true, 0, inf);
+        builder.addOutputArc("T3", "P0", 1);
+        builder.addOutputArc("T3", "P2", 1);
+        builder.addTransition("T4", 0, false, 0, 0);
+        builder.addInputArc("P1", "T4", false, 1, false, false, 2, 4);
+        builder.addInputArc("P2", "T4", false, 1, false, true, 0, inf);
+        builder.addOutputArc("T4", "P1", 1);
+        builder.addTransition("T5", 0, false, 0, 0);
+        builder.addInputArc("P2", "T5", false, 1, false, false, 1, 4);
+        builder.addOutputArc("T5", "P0", 1);
+    };
+    auto query = [] {
+        return new AST::Query(AST::AG, new AST::AtomicProposition(
+                new AST::IdentifierExpression(2), AST::AtomicProposition::NE, new AST::NumberExpression(2)));
+    };
+    for (auto [full, reduced, guided] : reachability(net, query)) {
+        BOOST_REQUIRE(full);
+        BOOST_REQUIRE_EQUAL(full, reduced);
+        BOOST_REQUIRE_EQUAL(full, guided);
+    }
+}
+
+// P0 -> T0 -> P1 next to an independent cycle Q0 -> T1 -> Q1 -> T2 -> Q0
+void por_cycle_net(TAPNModelBuilder& builder)
+{
+    const int inf = std::numeric_limits<int>::max();
+    builder.addPlace("P0", 1, true, inf);
+    builder.addPlace("P1", 0, true, inf);
+    builder.addPlace("Q0", 1, false, 2);
+    builder.addPlace("Q1", 0, false, 2);
+    builder.addTransition("T0", 0, false, 0, 0);
+    builder.addInputArc("P0", "T0", false, 1, false, false, 1, 2);
+    builder.addOutputArc("T0", "P1", 1);
+    builder.addTransition("T1", 0, false, 0, 0);
+    builder.addInputArc("Q0", "T1", false, 1, false, false, 1, 2);
+    builder.addOutputArc("T1", "Q1", 1);
+    builder.addTransition("T2", 0, false, 0, 0);
+    builder.addInputArc("Q1", "T2", false, 1, false, false, 0, 2);
+    builder.addOutputArc("T2", "Q0", 1);
+}
+
+BOOST_AUTO_TEST_CASE(por_minus)
+{
+    // The interesting transitions of a negated expression were found by visiting the negation itself again
+    auto query = [] {
+        return new AST::Query(AST::EF, new AST::AtomicProposition(
+                new AST::MinusExpression(new AST::IdentifierExpression(1)), AST::AtomicProposition::LT,
+                new AST::NumberExpression(0)));
+    };
+    for (auto [full, reduced, guided] : reachability(por_cycle_net, query)) {
+        BOOST_REQUIRE(full);
+        BOOST_REQUIRE_EQUAL(full, reduced);
+        BOOST_REQUIRE_EQUAL(full, guided);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(por_subtract)
+{
+    // Below a product both directions are interesting, for which a difference visited itself again
+    auto query = [] {
+        return new AST::Query(AST::EF, new AST::AtomicProposition(
+                new AST::NumberExpression(1), AST::AtomicProposition::LE,
+                new AST::MultiplyExpression(new AST::SubtractExpression(new AST::IdentifierExpression(1),
+                                                                        new AST::IdentifierExpression(3)),
+                                            new AST::NumberExpression(1))));
+    };
+    for (auto [full, reduced, guided] : reachability(por_cycle_net, query)) {
+        BOOST_REQUIRE(full);
+        BOOST_REQUIRE_EQUAL(full, reduced);
+        BOOST_REQUIRE_EQUAL(full, guided);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(deadlock_inhibitor_only)
+{
+    // No token is on a place with outgoing arcs, but the transition with only an inhibitor arc is enabled
+    // until it has put a token on its inhibiting place.
+    using namespace VerifyTAPN::DiscreteVerification;
+    const int inf = std::numeric_limits<int>::max();
+    for (int inhibiting : {0, 1}) {
+        TAPNModelBuilder builder;
+        builder.addPlace("R", 1, true, inf);
+        builder.addPlace("H", inhibiting, true, inf);
+        builder.addPlace("P", 0, true, inf);
+        builder.addTransition("I", 0, false, 0, 0);
+        builder.addInputArc("H", "I", true, 1, false, true, 0, inf);
+        builder.addOutputArc("I", "H", 1);
+        builder.addTransition("T", 0, false, 0, 0);
+        builder.addInputArc("P", "T", false, 1, false, true, 0, inf);
+        builder.addOutputArc("T", "R", 1);
+        std::unique_ptr<TAPN::TimedArcPetriNet> tapn(builder.make_tapn());
+        tapn->initialize(false, false);
+        NonStrictMarking marking(*tapn, builder.initialMarking());
+        BOOST_REQUIRE_EQUAL(marking.canDeadlock(*tapn, 0), inhibiting == 1);
+    }
+}
@@ -0,0 +1,125 @@
+/*
+ * Per-state cost of the stubborn set computation.
+ *
+ * Builds a net of C components, each a cycle of timed and urgent steps, with extra transitions moving tokens through
+ * a shared pool place guarded by inhibitor arcs on the next component. The reachable markings (delays included) are
+ * collected breadth-first up to a limit, then StubbornSet::prepare and pop_next are timed over them.
+ *
+ * Usage: stubborn_set_bench [components] [markings] [repetitions]
+ */
+
+#include "Core/TAPN/TAPNModelBuilder.hpp"
+#include "DiscreteVerification/DataStructures/NonStrictMarkingBase.hpp"
+#include "DiscreteVerification/Generators/Generator.h"
+#include "DiscreteVerification/Generators/StubbornSet.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+using namespace VerifyTAPN;
+using namespace VerifyTAPN::DiscreteVerification;
+
+int main(int argc, char **argv) {
+    const int components = argc > 1 ? std::atoi(argv[1]) : 16;
+    const size_t limit = argc > 2 ? std::atoi(argv[2]) : 20000;
+    const int repetitions = argc > 3 ? std::atoi(argv[3]) : 10;
+    const int inf = std::numeric_limits<int>::max();
+    const auto name = [](const char *prefix, int c) { return prefix + std::to_string(c); };
+
+    TAPNModelBuilder builder;
+    builder.addPlace("pool", components, true, inf);
+    for (int c = 0; c < components; ++c) {
+        builder.addPlace(name("A", c), 1, false, 3);
+        builder.addPlace(name("B", c), 0, true, inf);
+        builder.addPlace(name("D", c), 0, false, 2);
+    }
+    for (int c = 0; c < components; ++c) {
+        builder.addTransition(name("t", c), 0, false, 0, 0);
+        builder.addInputArc(name("A", c), name("t", c), false, 1, false, false, 1, 3);
+        builder.addOutputArc(name("t", c), name("B", c), 1);
+        builder.addTransition(name("u", c), 0, true, 0, 0);
+        builder.addInputArc(name("B", c), name("u", c), false, 1, false, true, 0, inf);
+        builder.addOutputArc(name("u", c), name("D", c), 1);
+        builder.addTransition(name("v", c), 0, false, 0, 0);
+        builder.addInputArc(name("D", c), name("v", c), false, 1, false, false, 2, 2);
+        builder.addOutputArc(name("v", c), name("A", c), 1);
+        builder.addTransition(name("w", c), 0, false, 0, 0);
+        builder.addInputArc("pool", name("w", c), false, 1, false, false, c % 4, c % 4 + 3);
+        builder.addInputArc(name("D", c), name("w", c), false, 1, false, false, 0, 2);
+        builder.addInputArc(name("A", (c + 1) % components), name("w", c), true, 1, false, true, 0, inf);
+        builder.addOutputArc(name("w", c), "pool", 1);
+        builder.addOutputArc(name("w", c), name("A", c), 1);
+    }
+    std::unique_ptr<TAPN::TimedArcPetriNet> tapn(builder.make_tapn());
+    tapn->initialize(false, false);
+
+    // EF B0 >= 1, so one component is interesting
+    AST::Query query(AST::EF, new AST::AtomicProposition(new AST::NumberExpression(0), AST::AtomicProposition::LT,
+                                                         new AST::IdentifierExpression(2)));
+    VerificationOptions options;
+    options.setKBound(3 * components + 2);
+    tapn->updatePlaceTypes(&query, options);
+
+    std::vector<std::unique_ptr<NonStrictMarkingBase>> markings;
+    std::unordered_set<size_t> seen;
+    std::deque<NonStrictMarkingBase *> waiting{new NonStrictMarkingBase(*tapn, builder.initialMarking())};
+    std::vector<int> placeStats(tapn->getNumberOfPlaces());
+    Generator generator(*tapn, &query);
+    auto add = [&](NonStrictMarkingBase *marking) {
+        marking->cut(placeStats);
+        if (seen.insert(marking->getHashKey()).second && marking->size() <= options.getKBound()) {
+            waiting.push_back(marking);
+        } else {
+            delete marking;
+        }
+    };
+    while (!waiting.empty() && markings.size() < limit) {
+        NonStrictMarkingBase *marking = waiting.front();
+        waiting.pop_front();
+        markings.emplace_back(marking);
+        generator.prepare(marking);
+        while (NonStrictMarkingBase *next = generator.next(false)) {
+            add(next);
+        }
+        auto *delayed = new NonStrictMarkingBase(*marking);
+        delayed->incrementAge();
+        bool invariants = true;
+        for (auto &place : delayed->getPlaceList()) {
+            invariants &= place.maxTokenAge() <= place.place->getInvariant().getBound();
+        }
+        if (invariants) {
+            add(delayed);
+        } else {
+            delete delayed;
+        }
+    }
+    for (auto *marking : waiting) {
+        delete marking;
+    }
+
+    StubbornSet stubborn(*tapn, &query);
+    size_t reduced = 0;
+    size_t fired = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        for (auto &marking : markings) {
+            stubborn.prepare(marking.get());
+            if (stubborn.irreducable()) continue;
+            ++reduced;
+            while (stubborn.pop_next() != nullptr) {
+                ++fired;
+            }
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "markings: " << markings.size() << ", transitions: " << tapn->getTransitions().size()
+              << ", reducible: " << reduced / repetitions << ", fired: " << fired / repetitions << std::endl;
+    std::cout << "ns per marking: " << seconds * 1e9 / (markings.size() * repetitions) << std::endl;
+    return 0;
+}